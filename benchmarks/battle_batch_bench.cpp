@@ -0,0 +1,68 @@
+#include "neuropet/compiled_board.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    std::size_t fights = 100000;
+    int iterations = 10;
+
+    if (argc > 1)
+        fights = static_cast<std::size_t>(std::atoi(argv[1]));
+    if (argc > 2)
+        iterations = std::atoi(argv[2]);
+
+    neuropet::BattleEngine engine;
+    engine.set_tile(3, 3, neuropet::BattleEngine::Tile::HAZARD);
+    engine.set_tile(4, 4, neuropet::BattleEngine::Tile::HAZARD);
+    engine.set_tile(2, 5, neuropet::BattleEngine::Tile::WALL);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> stat(1, 10);
+    std::vector<neuropet::CreatureStats> a(fights);
+    std::vector<neuropet::CreatureStats> b(fights);
+    neuropet::BattleBatch batch;
+    batch.reserve(fights);
+    for (std::size_t i = 0; i < fights; ++i) {
+        a[i] = {static_cast<std::uint32_t>(2 * i + 1), stat(rng), stat(rng), stat(rng)};
+        b[i] = {static_cast<std::uint32_t>(2 * i + 2), stat(rng), stat(rng), stat(rng)};
+        batch.add(a[i], b[i]);
+    }
+
+    std::vector<std::uint32_t> scalar(fights);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it)
+        for (std::size_t i = 0; i < fights; ++i)
+            scalar[i] = engine.fight(a[i], b[i]);
+    auto mid = std::chrono::high_resolution_clock::now();
+    std::vector<std::uint32_t> batched;
+    for (int it = 0; it < iterations; ++it)
+        batched = engine.fight_batch(batch);
+    auto end = std::chrono::high_resolution_clock::now();
+    neuropet::CompiledBoard compiled(engine);
+    std::vector<std::uint32_t> closed;
+    for (int it = 0; it < iterations; ++it)
+        closed = compiled.fight_batch(batch);
+    auto done = std::chrono::high_resolution_clock::now();
+
+    if (batched != scalar || closed != scalar) {
+        std::cerr << "batched results differ from fight" << std::endl;
+        return 1;
+    }
+
+    double total = static_cast<double>(fights) * iterations;
+    double scalar_sec = std::chrono::duration<double>(mid - start).count();
+    double batch_sec = std::chrono::duration<double>(end - mid).count();
+    double compiled_sec = std::chrono::duration<double>(done - end).count();
+    std::cout << "Battles " << fights << " x " << iterations << " iterations\n";
+    std::cout << "Lanes: " << neuropet::BattleEngine::kBatchLanes << "\n";
+    std::cout << "fight fights/s: " << total / scalar_sec << "\n";
+    std::cout << "fight_batch fights/s: " << total / batch_sec << "\n";
+    std::cout << "CompiledBoard fights/s: " << total / compiled_sec << "\n";
+    std::cout << "Speedup: " << scalar_sec / batch_sec << std::endl;
+
+    return 0;
+}
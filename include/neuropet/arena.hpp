@@ -13,8 +13,12 @@ class Arena {
 
     void set_ledger(MatchLedger* ledger) { ledger_ = ledger; }
 
+    /** Answer repeated pairings from ``memo``; ``nullptr`` disables caching. */
+    void set_memo(BattleMemo* memo) { memo_ = memo; }
+
     std::uint32_t battle(const CreatureStats& a, const CreatureStats& b, std::uint32_t seed = 0) {
-        std::uint32_t winner = engine_.fight(a, b, seed);
+        std::uint32_t winner =
+            memo_ ? memo_->fight(engine_, a, b, seed) : engine_.fight(a, b, seed);
         if (ledger_) {
             std::uint32_t loser = winner == a.id ? b.id : a.id;
             ledger_->record_result(winner, loser);
@@ -25,6 +29,7 @@ class Arena {
   private:
     BattleEngine engine_{};
     MatchLedger* ledger_{};
+    BattleMemo* memo_{};
 };
 
 } // namespace neuropet
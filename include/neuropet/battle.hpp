@@ -1,12 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include "neuropet/item.hpp"
 #include "neuropet/match_ledger.hpp"
+#include "neuropet/ring_queue.hpp"
 
 namespace neuropet {
 
@@ -51,7 +60,151 @@ struct CreatureStats {
     }
 };
 
-/** Deterministic battlefield engine on an 8×8 grid. */
+/**
+ * @brief Fixed-size creature with inline items and cached stat totals.
+ *
+ * Holds up to ``kMaxItems`` items without heap storage and keeps the totals
+ * up to date on ``attach_item``/``detach_item``, so ``total_*()`` are plain
+ * loads and copies are a ``memcpy``. Battles, batches and the matchmaker
+ * queue accept it wherever they accept ``CreatureStats``.
+ */
+class CompactCreature {
+  public:
+    static constexpr std::size_t kMaxItems = 8;
+
+    std::uint32_t id{0};
+
+    CompactCreature() = default;
+
+    CompactCreature(std::uint32_t creature_id, int power, int defense, int stamina)
+        : id{creature_id}, power_{power}, defense_{defense}, stamina_{stamina},
+          total_power_{power}, total_defense_{defense}, total_stamina_{stamina} {}
+
+    /**
+     * Convert from ``CreatureStats``. The first ``kMaxItems`` items stay
+     * detachable; the bonuses of any further items are folded into the base
+     * stats, so the totals and therefore battle outcomes match ``c`` exactly.
+     */
+    explicit CompactCreature(const CreatureStats& c)
+        : CompactCreature(c.id, c.power, c.defense, c.stamina) {
+        for (std::size_t i = 0; i < c.items.size(); ++i) {
+            const Item& item = c.items[i];
+            if (i < kMaxItems) {
+                attach_item(item);
+                continue;
+            }
+            power_ += item.power;
+            defense_ += item.defense;
+            stamina_ += item.stamina;
+            total_power_ += item.power;
+            total_defense_ += item.defense;
+            total_stamina_ += item.stamina;
+        }
+    }
+
+    /** Attach an item; throws ``std::runtime_error`` when all slots are used. */
+    void attach_item(const Item& item) {
+        if (item_count_ == kMaxItems)
+            throw std::runtime_error("creature item slots exhausted");
+        items_[item_count_++] = item;
+        total_power_ += item.power;
+        total_defense_ += item.defense;
+        total_stamina_ += item.stamina;
+    }
+
+    void detach_item(std::uint32_t item_id) {
+        for (std::size_t i = 0; i < item_count_; ++i) {
+            if (items_[i].id == item_id) {
+                total_power_ -= items_[i].power;
+                total_defense_ -= items_[i].defense;
+                total_stamina_ -= items_[i].stamina;
+                for (std::size_t j = i + 1; j < item_count_; ++j)
+                    items_[j - 1] = items_[j];
+                --item_count_;
+                break;
+            }
+        }
+    }
+
+    int power() const { return power_; }
+    int defense() const { return defense_; }
+    int stamina() const { return stamina_; }
+    std::size_t item_count() const { return item_count_; }
+    const Item& item(std::size_t i) const { return items_[i]; }
+
+    int total_power() const { return total_power_; }
+    int total_defense() const { return total_defense_; }
+    int total_stamina() const { return total_stamina_; }
+
+    /** Expand back into the heap-backed representation. */
+    CreatureStats to_stats() const {
+        CreatureStats c{id, power_, defense_, stamina_};
+        c.items.assign(items_, items_ + item_count_);
+        return c;
+    }
+
+  private:
+    int power_{0};
+    int defense_{0};
+    int stamina_{0};
+    Item items_[kMaxItems]{};
+    std::uint8_t item_count_{0};
+    int total_power_{0};
+    int total_defense_{0};
+    int total_stamina_{0};
+};
+
+static_assert(std::is_trivially_copyable_v<CompactCreature>,
+              "CompactCreature must stay trivially copyable");
+
+/**
+ * @brief Structure-of-arrays list of pairings for ``BattleEngine::fight_batch``.
+ *
+ * Item bonuses are folded into the totals when a pairing is added so the
+ * batch kernel never walks item vectors.
+ */
+struct BattleBatch {
+    std::vector<std::uint32_t> id_a{};
+    std::vector<std::uint32_t> id_b{};
+    std::vector<std::int32_t> power_a{};
+    std::vector<std::int32_t> defense_a{};
+    std::vector<std::int32_t> stamina_a{};
+    std::vector<std::int32_t> power_b{};
+    std::vector<std::int32_t> defense_b{};
+    std::vector<std::int32_t> stamina_b{};
+    std::vector<std::uint32_t> seed{};
+
+    /** Append a pairing; arguments match ``BattleEngine::fight``. */
+    template <class Creature = CreatureStats>
+    void add(const Creature& a, const Creature& b, std::uint32_t s = 0) {
+        id_a.push_back(a.id);
+        id_b.push_back(b.id);
+        power_a.push_back(a.total_power());
+        defense_a.push_back(a.total_defense());
+        stamina_a.push_back(a.total_stamina());
+        power_b.push_back(b.total_power());
+        defense_b.push_back(b.total_defense());
+        stamina_b.push_back(b.total_stamina());
+        seed.push_back(s);
+    }
+
+    void reserve(std::size_t n) {
+        for (auto* v : {&id_a, &id_b, &seed})
+            v->reserve(n);
+        for (auto* v : {&power_a, &defense_a, &stamina_a, &power_b, &defense_b, &stamina_b})
+            v->reserve(n);
+    }
+
+    std::size_t size() const { return id_a.size(); }
+};
+
+/**
+ * Deterministic battlefield engine on an 8×8 grid.
+ *
+ * Tiles are stored as two 64-bit bitboards, walls and hazards, with square
+ * ``(x, y)`` at bit ``x * 8 + y``. The engine is trivially copyable, so
+ * boards can be passed by value into batched simulations.
+ */
 class BattleEngine {
   public:
     enum class Tile { EMPTY, WALL, HAZARD };
@@ -61,26 +214,55 @@ class BattleEngine {
         int y{0};
     };
 
-    BattleEngine() { clear_board(); }
+    BattleEngine() = default;
+
+    /** Bitboard mask of square ``(x, y)``; zero when off the board. */
+    static constexpr std::uint64_t square(int x, int y) {
+        return (x >= 0 && x < 8 && y >= 0 && y < 8) ? std::uint64_t{1} << (x * 8 + y) : 0;
+    }
+
+    /** Squares orthogonally adjacent to ``(x, y)`` that lie on the board. */
+    static std::uint64_t neighbors(int x, int y) {
+        static constexpr auto table = [] {
+            std::array<std::uint64_t, 64> t{};
+            for (int i = 0; i < 64; ++i) {
+                int x = i / 8;
+                int y = i % 8;
+                t[i] = square(x - 1, y) | square(x + 1, y) | square(x, y - 1) | square(x, y + 1);
+            }
+            return t;
+        }();
+        return square(x, y) ? table[x * 8 + y] : 0;
+    }
 
     /** Clear the entire board to empty tiles. */
     void clear_board() {
-        for (auto& row : board_)
-            for (auto& t : row)
-                t = Tile::EMPTY;
+        walls_ = 0;
+        hazards_ = 0;
     }
 
     /** Set the tile type at the given coordinates. */
     void set_tile(int x, int y, Tile t) {
-        if (x >= 0 && x < 8 && y >= 0 && y < 8)
-            board_[x][y] = t;
+        const std::uint64_t m = square(x, y);
+        walls_ = t == Tile::WALL ? walls_ | m : walls_ & ~m;
+        hazards_ = t == Tile::HAZARD ? hazards_ | m : hazards_ & ~m;
     }
 
+    std::uint64_t walls() const { return walls_; }
+    std::uint64_t hazards() const { return hazards_; }
+
+    /**
+     * 64-bit digest of the tiles, mixed from both bitboards. The empty board
+     * hashes to zero.
+     */
+    std::uint64_t board_digest() const { return mix(walls_ ^ mix(hazards_)); }
+
     /** Return the tile type at the given coordinates. */
     Tile tile_at(int x, int y) const {
-        if (x >= 0 && x < 8 && y >= 0 && y < 8)
-            return board_[x][y];
-        return Tile::WALL; // treat out-of-bounds as wall
+        const std::uint64_t m = square(x, y);
+        if (!m || (walls_ & m))
+            return Tile::WALL; // treat out-of-bounds as wall
+        return (hazards_ & m) ? Tile::HAZARD : Tile::EMPTY;
     }
 
     /**
@@ -88,11 +270,14 @@ class BattleEngine {
      * The starting turn is derived from `seed = creatureA_id XOR creatureB_id`.
      * Creatures begin in opposite corners and move toward each other until they
      * are adjacent, then attack until one runs out of health or stamina.
+     * ``Creature`` is ``CreatureStats`` or ``CompactCreature``.
      */
-    std::uint32_t fight(const CreatureStats& a, const CreatureStats& b,
-                        std::uint32_t seed = 0) const {
+    template <class Creature = CreatureStats>
+    std::uint32_t fight(const Creature& a, const Creature& b, std::uint32_t seed = 0) const {
         Position posA{0, 0};
         Position posB{7, 7};
+        const int powA = a.total_power();
+        const int powB = b.total_power();
         int hpA = a.total_defense();
         int hpB = b.total_defense();
         int staA = a.total_stamina();
@@ -100,43 +285,11 @@ class BattleEngine {
         unsigned s = seed ? seed : (a.id ^ b.id);
         bool a_turn = (s & 1u) == 0;
 
-        if (board_[posA.x][posA.y] == Tile::HAZARD)
+        if (hazards_ & square(posA.x, posA.y))
             --hpA;
-        if (board_[posB.x][posB.y] == Tile::HAZARD)
+        if (hazards_ & square(posB.x, posB.y))
             --hpB;
 
-        auto step_towards = [&](Position& from, const Position& to, int& hp) {
-            auto try_move = [&](int nx, int ny) {
-                if (nx < 0 || nx >= 8 || ny < 0 || ny >= 8)
-                    return false;
-                if (board_[nx][ny] == Tile::WALL)
-                    return false;
-                from.x = nx;
-                from.y = ny;
-                if (board_[nx][ny] == Tile::HAZARD)
-                    --hp;
-                return true;
-            };
-
-            int dx = 0;
-            int dy = 0;
-            if (from.x < to.x)
-                dx = 1;
-            else if (from.x > to.x)
-                dx = -1;
-            else if (from.y < to.y)
-                dy = 1;
-            else if (from.y > to.y)
-                dy = -1;
-
-            if (!try_move(from.x + dx, from.y + dy)) {
-                if (dx != 0 && from.y != to.y)
-                    try_move(from.x, from.y + (from.y < to.y ? 1 : -1));
-                else if (dy != 0 && from.x != to.x)
-                    try_move(from.x + (from.x < to.x ? 1 : -1), from.y);
-            }
-        };
-
         int blockA = 0;
         int blockB = 0;
 
@@ -148,7 +301,7 @@ class BattleEngine {
             if (a_turn) {
                 if (distance(posA, posB) <= 1) {
                     if (staA > 0) {
-                        int dmg = a.total_power();
+                        int dmg = powA;
                         if (blockB > 0) {
                             dmg -= blockB;
                             if (dmg < 0)
@@ -166,7 +319,7 @@ class BattleEngine {
             } else {
                 if (distance(posA, posB) <= 1) {
                     if (staB > 0) {
-                        int dmg = b.total_power();
+                        int dmg = powB;
                         if (blockA > 0) {
                             dmg -= blockA;
                             if (dmg < 0)
@@ -187,11 +340,356 @@ class BattleEngine {
         return (hpA >= hpB) ? a.id : b.id;
     }
 
+    /**
+     * Turn-by-turn walk toward contact for one starting side. ``hazard[t]``
+     * is the damage taken by the creature moving on turn ``t`` (A moves on
+     * even turns when ``a_first``); from turn ``contact`` on the creatures are
+     * adjacent, or can never meet if ``stuck`` is set.
+     */
+    struct ApproachPlan {
+        bool a_first{true};
+        std::vector<std::int32_t> hazard{};
+        std::size_t contact{0};
+        bool stuck{false};
+    };
+
+    /** Replay the movement rules of ``fight`` until the creatures meet. */
+    ApproachPlan plan_approach(bool a_first) const {
+        ApproachPlan plan;
+        plan.a_first = a_first;
+        Position a{0, 0};
+        Position b{7, 7};
+        bool a_turn = a_first;
+        int failed = 0;
+        while (std::abs(a.x - b.x) + std::abs(a.y - b.y) > 1) {
+            int hp = 0;
+            bool moved = a_turn ? step_towards(a, b, hp) : step_towards(b, a, hp);
+            failed = moved ? 0 : failed + 1;
+            if (failed >= 2) {
+                plan.stuck = true;
+                break;
+            }
+            plan.hazard.push_back(-hp);
+            a_turn = !a_turn;
+        }
+        plan.contact = plan.hazard.size();
+        return plan;
+    }
+
+#if defined(__AVX512F__)
+    static constexpr std::size_t kBatchLanes = 16;
+#else
+    static constexpr std::size_t kBatchLanes = 8;
+#endif
+
+    /**
+     * @brief Resolve every pairing in ``batch`` and return the winners' ids.
+     *
+     * Results are identical to calling ``fight`` for each pairing. Movement
+     * only depends on the board and on which creature moves first, so both
+     * possible approach paths are walked once per call. Fights then run
+     * ``kBatchLanes`` at a time in lockstep, where the per-turn update is
+     * branch-free integer arithmetic over a live mask that compilers
+     * vectorize. Throws ``std::runtime_error`` if the creatures of a pending
+     * fight can never become adjacent on this board, where ``fight`` would
+     * loop forever.
+     */
+    std::vector<std::uint32_t> fight_batch(const BattleBatch& batch) const {
+        std::vector<std::uint32_t> winners(batch.size());
+        if (batch.size() == 0)
+            return winners;
+        const ApproachPlan plans[2] = {plan_approach(true), plan_approach(false)};
+        for (std::size_t off = 0; off < batch.size(); off += kBatchLanes)
+            fight_lanes<kBatchLanes>(plans, batch, off, winners.data() + off);
+        return winners;
+    }
+
   private:
-    Tile board_[8][8]{};
+    /** SplitMix64 finalizer; maps zero to zero. */
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /** Move one tile toward ``to``; returns false if the move was blocked. */
+    bool step_towards(Position& from, const Position& to, int& hp) const {
+        const std::uint64_t open = neighbors(from.x, from.y) & ~walls_;
+        auto try_move = [&](int nx, int ny) {
+            const std::uint64_t m = square(nx, ny);
+            if (!(open & m))
+                return false;
+            from.x = nx;
+            from.y = ny;
+            if (hazards_ & m)
+                --hp;
+            return true;
+        };
+
+        int dx = 0;
+        int dy = 0;
+        if (from.x < to.x)
+            dx = 1;
+        else if (from.x > to.x)
+            dx = -1;
+        else if (from.y < to.y)
+            dy = 1;
+        else if (from.y > to.y)
+            dy = -1;
+
+        if (try_move(from.x + dx, from.y + dy))
+            return true;
+        if (dx != 0 && from.y != to.y)
+            return try_move(from.x, from.y + (from.y < to.y ? 1 : -1));
+        if (dy != 0 && from.x != to.x)
+            return try_move(from.x + (from.x < to.x ? 1 : -1), from.y);
+        return false;
+    }
+
+    template <std::size_t L>
+    void fight_lanes(const ApproachPlan (&plans)[2], const BattleBatch& in, std::size_t off,
+                     std::uint32_t* out) const {
+        const std::size_t n = std::min(L, in.size() - off);
+        const std::int32_t start_a = (hazards_ & square(0, 0)) ? 1 : 0;
+        const std::int32_t start_b = (hazards_ & square(7, 7)) ? 1 : 0;
+
+        alignas(64) std::int32_t hpA[L], hpB[L], staA[L], staB[L];
+        alignas(64) std::int32_t powA[L], powB[L], blkA[L], blkB[L];
+        alignas(64) std::int32_t grp[L], live[L];
+        for (std::size_t l = 0; l < L; ++l) {
+            bool used = l < n;
+            std::size_t i = off + (used ? l : 0);
+            hpA[l] = in.defense_a[i] - start_a;
+            hpB[l] = in.defense_b[i] - start_b;
+            staA[l] = in.stamina_a[i];
+            staB[l] = in.stamina_b[i];
+            powA[l] = in.power_a[i];
+            powB[l] = in.power_b[i];
+            blkA[l] = 0;
+            blkB[l] = 0;
+            std::uint32_t s = in.seed[i] ? in.seed[i] : (in.id_a[i] ^ in.id_b[i]);
+            grp[l] = static_cast<std::int32_t>(s & 1u);
+            live[l] = used && hpA[l] > 0 && hpB[l] > 0 && (staA[l] > 0 || staB[l] > 0);
+        }
+
+        for (std::size_t turn = 0;; ++turn) {
+            std::int32_t any = 0;
+            for (std::size_t l = 0; l < L; ++l)
+                any |= live[l];
+            if (!any)
+                break;
+
+            // Both starting sides share one path, so per-turn events are scalars.
+            std::int32_t mover_a[2], adjacent[2], hazard[2];
+            for (int g = 0; g < 2; ++g) {
+                const ApproachPlan& p = plans[g];
+                mover_a[g] = p.a_first == ((turn & 1) == 0);
+                adjacent[g] = turn >= p.contact;
+                hazard[g] = adjacent[g] ? 0 : p.hazard[turn];
+                if (adjacent[g] && p.stuck) {
+                    for (std::size_t l = 0; l < L; ++l)
+                        if (live[l] && grp[l] == g)
+                            throw std::runtime_error("creatures can never meet on this board");
+                }
+            }
+            const std::int32_t is_a0 = mover_a[0], is_a_x = mover_a[0] ^ mover_a[1];
+            const std::int32_t adj0 = adjacent[0], adj_x = adjacent[0] ^ adjacent[1];
+            const std::int32_t hz0 = hazard[0], hz_x = hazard[0] ^ hazard[1];
+
+            // Lane update: selects are expressed as masks so the loop stays
+            // free of branches and conditional loads.
+            for (std::size_t l = 0; l < L; ++l) {
+                const std::int32_t g = -grp[l];
+                const std::int32_t m = live[l];
+                const std::int32_t is_a = is_a0 ^ (is_a_x & g);
+                const std::int32_t adj = adj0 ^ (adj_x & g);
+                const std::int32_t hz = hz0 ^ (hz_x & g);
+
+                const std::int32_t act_a = m & is_a & adj;
+                const std::int32_t act_b = m & (is_a ^ 1) & adj;
+                const std::int32_t hit_a = act_a & (staA[l] > 0);
+                const std::int32_t hit_b = act_b & (staB[l] > 0);
+                const std::int32_t blocked_b = -(blkB[l] > 0);
+                const std::int32_t blocked_a = -(blkA[l] > 0);
+                const std::int32_t dmg_a =
+                    (std::max(powA[l] - blkB[l], 0) & blocked_b) | (powA[l] & ~blocked_b);
+                const std::int32_t dmg_b =
+                    (std::max(powB[l] - blkA[l], 0) & blocked_a) | (powB[l] & ~blocked_a);
+
+                hpB[l] -= dmg_a & -hit_a;
+                hpA[l] -= dmg_b & -hit_b;
+                staA[l] -= hit_a;
+                staB[l] -= hit_b;
+                blkB[l] &= hit_a - 1;
+                blkA[l] &= hit_b - 1;
+                blkA[l] += act_a & (hit_a ^ 1);
+                blkB[l] += act_b & (hit_b ^ 1);
+
+                const std::int32_t walk = m & (adj ^ 1);
+                hpA[l] -= hz & -(walk & is_a);
+                hpB[l] -= hz & -(walk & (is_a ^ 1));
+
+                live[l] = m & (hpA[l] > 0) & (hpB[l] > 0) & ((staA[l] > 0) | (staB[l] > 0));
+            }
+        }
+
+        for (std::size_t l = 0; l < n; ++l)
+            out[l] = hpA[l] >= hpB[l] ? in.id_a[off + l] : in.id_b[off + l];
+    }
+
+    std::uint64_t walls_{0};
+    std::uint64_t hazards_{0};
+};
+
+static_assert(std::is_trivially_copyable<BattleEngine>::value,
+              "BattleEngine must stay trivially copyable");
+
+/** Sizing of a ``BattleMemo``. */
+struct BattleMemoOptions {
+    /// Maximum number of memoized results across all shards.
+    std::size_t capacity{1u << 16};
+    /// Independently locked partitions; rounded up to a power of two.
+    std::size_t shards{16};
+};
+
+/**
+ * @brief Bounded, thread-safe cache of fight outcomes.
+ *
+ * ``BattleEngine::fight`` only depends on the creatures' stat totals, the
+ * board tiles and the low bit of the effective seed, so results are keyed on
+ * exactly those inputs. The key holds the full wall and hazard bitboards and
+ * every field is compared on lookup; ``board_digest`` only spreads keys over
+ * the table. Results for an edited board are never returned and simply age
+ * out. Entries live in fixed-size
+ * direct-mapped tables split into shards with one mutex each; a colliding
+ * insert replaces the previous entry, which bounds memory at ``capacity``
+ * entries. One memo may be shared by any number of arenas and matchmakers.
+ */
+class BattleMemo {
+  public:
+    explicit BattleMemo(BattleMemoOptions opts = {}) {
+        std::size_t shards = 1;
+        while (shards < std::max<std::size_t>(opts.shards, 1))
+            shards <<= 1;
+        std::size_t slots = 1;
+        while (slots * shards < std::max(opts.capacity, shards))
+            slots <<= 1;
+        shard_mask_ = shards - 1;
+        slot_mask_ = slots - 1;
+        shards_ = std::make_unique<Shard[]>(shards);
+        for (std::size_t i = 0; i < shards; ++i)
+            shards_[i].slots.resize(slots);
+    }
+
+    /** ``engine.fight(a, b, seed)``, answered from the cache when possible. */
+    template <class Creature = CreatureStats>
+    std::uint32_t fight(const BattleEngine& engine, const Creature& a, const Creature& b,
+                        std::uint32_t seed = 0) {
+        unsigned s = seed ? seed : (a.id ^ b.id);
+        Key key{{a.total_power(), a.total_defense(), a.total_stamina(), b.total_power(),
+                 b.total_defense(), b.total_stamina()},
+                engine.walls(),
+                engine.hazards(),
+                static_cast<std::uint32_t>(s & 1u)};
+        std::uint64_t h = hash(key, engine.board_digest());
+        Shard& shard = shards_[h & shard_mask_];
+        Entry& slot = shard.slots[(h >> 32) & slot_mask_];
+        {
+            std::lock_guard<std::mutex> lk(shard.m);
+            if (slot.valid && slot.key == key) {
+                ++shard.hits;
+                return slot.a_wins ? a.id : b.id;
+            }
+            ++shard.misses;
+        }
+        std::uint32_t winner = engine.fight(a, b, seed);
+        std::lock_guard<std::mutex> lk(shard.m);
+        slot.key = key;
+        slot.a_wins = winner == a.id;
+        slot.valid = true;
+        return winner;
+    }
+
+    std::uint64_t hits() const { return sum(&Shard::hits); }
+    std::uint64_t misses() const { return sum(&Shard::misses); }
+
+    /** Fraction of lookups served from the cache. */
+    double hit_rate() const {
+        std::uint64_t h = hits();
+        std::uint64_t total = h + misses();
+        return total ? static_cast<double>(h) / static_cast<double>(total) : 0.0;
+    }
+
+    /** Maximum number of entries held at once. */
+    std::size_t capacity() const { return (shard_mask_ + 1) * (slot_mask_ + 1); }
+
+    /** Drop every entry and reset the counters. */
+    void clear() {
+        for (std::size_t i = 0; i <= shard_mask_; ++i) {
+            std::lock_guard<std::mutex> lk(shards_[i].m);
+            for (auto& e : shards_[i].slots)
+                e.valid = false;
+            shards_[i].hits = 0;
+            shards_[i].misses = 0;
+        }
+    }
+
+  private:
+    struct Key {
+        std::int32_t stats[6]{};
+        std::uint64_t walls{0};
+        std::uint64_t hazards{0};
+        std::uint32_t parity{0};
+
+        bool operator==(const Key& o) const {
+            return walls == o.walls && hazards == o.hazards && parity == o.parity &&
+                   std::equal(std::begin(stats), std::end(stats), std::begin(o.stats));
+        }
+    };
+
+    struct Entry {
+        Key key{};
+        bool a_wins{false};
+        bool valid{false};
+    };
+
+    struct alignas(64) Shard {
+        std::mutex m{};
+        std::vector<Entry> slots{};
+        std::uint64_t hits{0};
+        std::uint64_t misses{0};
+    };
+
+    static std::uint64_t hash(const Key& k, std::uint64_t board_digest) {
+        std::uint64_t h = board_digest ^ (k.parity * 0x9E3779B97F4A7C15ull);
+        for (std::int32_t v : k.stats) {
+            h = (h ^ static_cast<std::uint32_t>(v)) * 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 29;
+        }
+        return h * 0x94D049BB133111EBull;
+    }
+
+    std::uint64_t sum(std::uint64_t Shard::*field) const {
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i <= shard_mask_; ++i) {
+            std::lock_guard<std::mutex> lk(shards_[i].m);
+            total += shards_[i].*field;
+        }
+        return total;
+    }
+
+    std::unique_ptr<Shard[]> shards_{};
+    std::size_t shard_mask_{0};
+    std::size_t slot_mask_{0};
 };
 
-/** Simple FIFO matchmaker running synchronous battles. */
+/**
+ * @brief Simple FIFO matchmaker running synchronous battles.
+ *
+ * Queued creatures are stored as ``CompactCreature`` values in a ring buffer,
+ * so enqueueing never allocates per creature and every match is O(1). See
+ * ``ConcurrentMatchmaker`` for multi-threaded producers.
+ */
 class Matchmaker {
   public:
     explicit Matchmaker(const BattleEngine& engine = BattleEngine(), MatchLedger* ledger = nullptr)
@@ -199,8 +697,13 @@ class Matchmaker {
 
     void set_ledger(MatchLedger* ledger) { ledger_ = ledger; }
 
+    /** Answer repeated pairings from ``memo``; ``nullptr`` disables caching. */
+    void set_memo(BattleMemo* memo) { memo_ = memo; }
+
     /** Add a creature to the matchmaking queue. */
-    void enqueue(const CreatureStats& creature) { queue_.push_back(creature); }
+    void enqueue(const CompactCreature& creature) { queue_.push_back(creature); }
+
+    void enqueue(const CreatureStats& creature) { queue_.push_back(CompactCreature(creature)); }
 
     /**
      * Attempt to run a match if two or more creatures are waiting.
@@ -209,11 +712,12 @@ class Matchmaker {
     std::optional<std::uint32_t> try_match(std::uint32_t seed = 0) {
         if (queue_.size() < 2)
             return std::nullopt;
-        CreatureStats a = queue_.front();
-        queue_.erase(queue_.begin());
-        CreatureStats b = queue_.front();
-        queue_.erase(queue_.begin());
-        std::uint32_t winner = engine_.fight(a, b, seed);
+        CompactCreature a = queue_.front();
+        queue_.pop_front();
+        CompactCreature b = queue_.front();
+        queue_.pop_front();
+        std::uint32_t winner =
+            memo_ ? memo_->fight(engine_, a, b, seed) : engine_.fight(a, b, seed);
         if (ledger_) {
             std::uint32_t loser = winner == a.id ? b.id : a.id;
             ledger_->record_result(winner, loser);
@@ -225,9 +729,10 @@ class Matchmaker {
     std::size_t pending() const { return queue_.size(); }
 
   private:
-    std::vector<CreatureStats> queue_{};
+    RingQueue<CompactCreature> queue_{};
     BattleEngine engine_{};
     MatchLedger* ledger_{};
+    BattleMemo* memo_{};
 };
 
 } // namespace neuropet
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
 #include <vector>
 
 #include "neuropet/battle.hpp"
+#include "neuropet/parallel.hpp"
 
 namespace neuropet {
 
@@ -16,6 +24,227 @@ struct BattleFrame {
     int stamina_b{0};
 };
 
+/**
+ * @brief Streams ``BattleFrame`` values in a compact delta encoding.
+ *
+ * Each frame is four LEB128 varints holding the zigzag-encoded differences of
+ * ``hp_a``, ``hp_b``, ``stamina_a`` and ``stamina_b`` from the previous frame
+ * (all zero before the first), with the attacker flag in the low bit of the
+ * first varint. A typical attack frame takes four bytes instead of 20.
+ */
+class BattleFrameWriter {
+  public:
+    explicit BattleFrameWriter(std::ostream& out) : out_{out} {}
+
+    void write(const BattleFrame& f) {
+        char buf[4 * 10];
+        std::size_t n = 0;
+        n += put(buf + n, (zigzag(std::int64_t{f.hp_a} - prev_.hp_a) << 1) |
+                              (f.attacker_is_a ? 1u : 0u));
+        n += put(buf + n, zigzag(std::int64_t{f.hp_b} - prev_.hp_b));
+        n += put(buf + n, zigzag(std::int64_t{f.stamina_a} - prev_.stamina_a));
+        n += put(buf + n, zigzag(std::int64_t{f.stamina_b} - prev_.stamina_b));
+        out_.write(buf, static_cast<std::streamsize>(n));
+        prev_ = f;
+        ++frames_;
+        bytes_ += n;
+    }
+
+    /** Number of frames written. */
+    std::size_t frames() const { return frames_; }
+
+    /** Number of encoded bytes written. */
+    std::size_t bytes() const { return bytes_; }
+
+  private:
+    static std::uint64_t zigzag(std::int64_t v) {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    static std::size_t put(char* out, std::uint64_t v) {
+        std::size_t n = 0;
+        while (v >= 0x80) {
+            out[n++] = static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        out[n++] = static_cast<char>(v);
+        return n;
+    }
+
+    std::ostream& out_;
+    BattleFrame prev_{false, 0, 0, 0, 0};
+    std::size_t frames_{0};
+    std::size_t bytes_{0};
+};
+
+/**
+ * @brief Decodes a ``BattleFrameWriter`` stream one frame at a time.
+ *
+ * Reads either from memory without copying or from a ``std::istream``
+ * through a fixed-size buffer, so arbitrarily long streams decode in
+ * constant memory. ``begin``/``end`` expose the frames as an input range
+ * for ``BattleAnimator::replay``. A stream cut inside a frame or holding an
+ * out-of-range value throws ``std::runtime_error``.
+ */
+class BattleFrameReader {
+  public:
+    explicit BattleFrameReader(std::istream& in, std::size_t buffer_size = 1u << 16)
+        : in_{&in}, buffer_(buffer_size ? buffer_size : 1) {}
+
+    BattleFrameReader(const std::uint8_t* data, std::size_t size) : pos_{data}, end_{data + size} {}
+
+    /** Decode the next frame into ``f``; returns false at the end of the stream. */
+    bool next(BattleFrame& f) {
+        if (static_cast<std::size_t>(end_ - pos_) >= kMaxFrameBytes)
+            return next_buffered(f);
+        std::uint8_t byte;
+        if (!get(byte))
+            return false;
+        std::uint64_t first = varint(byte);
+        prev_.attacker_is_a = (first & 1u) != 0;
+        prev_.hp_a = apply(prev_.hp_a, first >> 1);
+        prev_.hp_b = apply(prev_.hp_b, varint());
+        prev_.stamina_a = apply(prev_.stamina_a, varint());
+        prev_.stamina_b = apply(prev_.stamina_b, varint());
+        f = prev_;
+        return true;
+    }
+
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = BattleFrame;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const BattleFrame*;
+        using reference = const BattleFrame&;
+
+        iterator() = default;
+        explicit iterator(BattleFrameReader* reader) : reader_{reader} { ++*this; }
+
+        reference operator*() const { return frame_; }
+        pointer operator->() const { return &frame_; }
+
+        iterator& operator++() {
+            if (reader_ && !reader_->next(frame_))
+                reader_ = nullptr;
+            return *this;
+        }
+
+        bool operator==(const iterator& o) const { return reader_ == o.reader_; }
+        bool operator!=(const iterator& o) const { return reader_ != o.reader_; }
+
+      private:
+        BattleFrameReader* reader_{nullptr};
+        BattleFrame frame_{};
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+  private:
+    static constexpr std::size_t kMaxFrameBytes = 4 * 10;
+
+    /** Decode a frame known to be fully buffered without per-byte refill checks. */
+    bool next_buffered(BattleFrame& f) {
+        const std::uint8_t* p = pos_;
+        std::uint64_t v[4];
+        for (auto& x : v) {
+            x = *p++;
+            if (x & 0x80u) {
+                x &= 0x7Fu;
+                int shift = 7;
+                std::uint8_t byte;
+                do {
+                    if (shift > 63)
+                        throw std::runtime_error("malformed battle frame varint");
+                    byte = *p++;
+                    x |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+                    shift += 7;
+                } while (byte & 0x80u);
+            }
+        }
+        pos_ = p;
+        prev_.attacker_is_a = (v[0] & 1u) != 0;
+        prev_.hp_a = apply(prev_.hp_a, v[0] >> 1);
+        prev_.hp_b = apply(prev_.hp_b, v[1]);
+        prev_.stamina_a = apply(prev_.stamina_a, v[2]);
+        prev_.stamina_b = apply(prev_.stamina_b, v[3]);
+        f = prev_;
+        return true;
+    }
+
+    bool get(std::uint8_t& byte) {
+        if (pos_ == end_ && !refill())
+            return false;
+        byte = *pos_++;
+        return true;
+    }
+
+    bool refill() {
+        if (!in_)
+            return false;
+        in_->read(reinterpret_cast<char*>(buffer_.data()),
+                  static_cast<std::streamsize>(buffer_.size()));
+        std::size_t n = static_cast<std::size_t>(in_->gcount());
+        pos_ = buffer_.data();
+        end_ = pos_ + n;
+        return n > 0;
+    }
+
+    std::uint64_t varint() {
+        std::uint8_t byte;
+        if (!get(byte))
+            throw std::runtime_error("truncated battle frame stream");
+        return varint(byte);
+    }
+
+    std::uint64_t varint(std::uint8_t byte) {
+        if (!(byte & 0x80u))
+            return byte;
+        std::uint64_t v = byte & 0x7Fu;
+        for (int shift = 7; byte & 0x80u; shift += 7) {
+            if (shift > 63)
+                throw std::runtime_error("malformed battle frame varint");
+            if (!get(byte))
+                throw std::runtime_error("truncated battle frame stream");
+            v |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+        }
+        return v;
+    }
+
+    static int apply(int prev, std::uint64_t zz) {
+        std::int64_t delta = static_cast<std::int64_t>(zz >> 1) ^ -static_cast<std::int64_t>(zz & 1);
+        std::int64_t v = prev + delta;
+        if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max())
+            throw std::runtime_error("battle frame value out of range");
+        return static_cast<int>(v);
+    }
+
+    std::istream* in_{nullptr};
+    std::vector<std::uint8_t> buffer_{};
+    const std::uint8_t* pos_{nullptr};
+    const std::uint8_t* end_{nullptr};
+    BattleFrame prev_{false, 0, 0, 0, 0};
+};
+
+/** One battle to verify with ``BattleAnimator::replay_batch``. */
+struct ReplayTask {
+    const CreatureStats* a{nullptr};
+    const CreatureStats* b{nullptr};
+    const std::vector<BattleFrame>* frames{nullptr};
+};
+
+/** Verdicts of ``BattleAnimator::replay_batch``. */
+struct ReplayBatchResult {
+    /// Winner per task in input order, 0 where the frames are inconsistent.
+    std::vector<std::uint32_t> winners{};
+    /// Number of inconsistent tasks.
+    std::size_t failed{0};
+    /// FNV-1a 64 over the winners in input order, for comparing verdicts
+    /// between validators.
+    std::uint64_t digest{0};
+};
+
 /**
  * Records the sequence of actions during a battle so the outcome can
  * be deterministically replayed.
@@ -25,31 +254,16 @@ class BattleAnimator {
     /** Run the battle simulation and record frames. */
     void run(const CreatureStats& a, const CreatureStats& b, std::uint32_t seed = 0) {
         frames_.clear();
-        std::uint32_t state = seed ? seed : (a.id ^ b.id);
-        auto rng = [&state]() {
-            state ^= state << 13;
-            state ^= state >> 17;
-            state ^= state << 5;
-            return state;
-        };
-        int hpA = a.total_defense();
-        int hpB = b.total_defense();
-        int staA = a.total_stamina();
-        int staB = b.total_stamina();
-        bool turn = rng() & 1u;
-        while (hpA > 0 && hpB > 0 && (staA > 0 || staB > 0)) {
-            if (turn && staA > 0) {
-                hpB -= a.total_power();
-                --staA;
-                frames_.push_back({true, hpA, hpB, staA, staB});
-            } else if (!turn && staB > 0) {
-                hpA -= b.total_power();
-                --staB;
-                frames_.push_back({false, hpA, hpB, staA, staB});
-            }
-            turn = rng() & 1u;
-        }
-        winner_ = (hpA >= hpB) ? a.id : b.id;
+        winner_ = simulate(a, b, seed, [this](const BattleFrame& f) { frames_.push_back(f); });
+    }
+
+    /**
+     * Run the battle simulation and stream the frames to ``out`` instead of
+     * keeping them; ``frames()`` is left untouched.
+     */
+    void record(const CreatureStats& a, const CreatureStats& b, std::uint32_t seed,
+                BattleFrameWriter& out) {
+        winner_ = simulate(a, b, seed, [&out](const BattleFrame& f) { out.write(f); });
     }
 
     /** Return the recorded animation frames. */
@@ -69,11 +283,23 @@ class BattleAnimator {
      */
     static std::uint32_t replay(const CreatureStats& a, const CreatureStats& b,
                                 const std::vector<BattleFrame>& frames) {
+        return replay(a, b, frames.begin(), frames.end());
+    }
+
+    /**
+     * Replay frames from any input range, such as a ``BattleFrameReader``,
+     * checking each one as it arrives so streams verify in constant memory.
+     * @return Winner id or 0 if the frames are inconsistent
+     */
+    template <class FrameIt>
+    static std::uint32_t replay(const CreatureStats& a, const CreatureStats& b, FrameIt first,
+                                FrameIt last) {
         int hpA = a.total_defense();
         int hpB = b.total_defense();
         int staA = a.total_stamina();
         int staB = b.total_stamina();
-        for (const auto& f : frames) {
+        for (; first != last; ++first) {
+            const BattleFrame& f = *first;
             if (f.attacker_is_a) {
                 if (staA <= 0)
                     return 0;
@@ -93,7 +319,90 @@ class BattleAnimator {
         return (hpA >= hpB) ? a.id : b.id;
     }
 
+    /**
+     * Replay many battles across ``threads`` workers (zero uses all cores).
+     *
+     * Tasks are ordered by frame count, largest first, and small ones are
+     * grouped into chunks of roughly ``chunk_frames`` frames so workers pull
+     * evenly sized units of work. Verdicts and the digest only depend on the
+     * input order. Throws ``std::runtime_error`` if a task has a null pointer.
+     */
+    static ReplayBatchResult replay_batch(const std::vector<ReplayTask>& tasks,
+                                          unsigned threads = 0,
+                                          std::size_t chunk_frames = 4096) {
+        for (const auto& t : tasks)
+            if (!t.a || !t.b || !t.frames)
+                throw std::runtime_error("incomplete replay task");
+        std::vector<std::size_t> order(tasks.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+            return tasks[x].frames->size() > tasks[y].frames->size();
+        });
+        std::vector<std::size_t> bounds{0};
+        std::size_t frames = 0;
+        for (std::size_t k = 0; k < order.size(); ++k) {
+            frames += tasks[order[k]].frames->size() + 1;
+            if (frames >= chunk_frames) {
+                bounds.push_back(k + 1);
+                frames = 0;
+            }
+        }
+        if (bounds.back() != order.size())
+            bounds.push_back(order.size());
+
+        ReplayBatchResult result;
+        result.winners.resize(tasks.size());
+        parallel_for(bounds.size() - 1, threads, [&](std::size_t c) {
+            for (std::size_t k = bounds[c]; k < bounds[c + 1]; ++k) {
+                const ReplayTask& t = tasks[order[k]];
+                result.winners[order[k]] = replay(*t.a, *t.b, *t.frames);
+            }
+        });
+
+        std::uint64_t h = 14695981039346656037ull;
+        for (std::uint32_t w : result.winners) {
+            result.failed += w == 0;
+            for (int i = 0; i < 4; ++i) {
+                h ^= (w >> (8 * i)) & 0xFFu;
+                h *= 1099511628211ull;
+            }
+        }
+        result.digest = h;
+        return result;
+    }
+
   private:
+    template <class Emit>
+    static std::uint32_t simulate(const CreatureStats& a, const CreatureStats& b,
+                                  std::uint32_t seed, Emit&& emit) {
+        std::uint32_t state = seed ? seed : (a.id ^ b.id);
+        auto rng = [&state]() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        };
+        int hpA = a.total_defense();
+        int hpB = b.total_defense();
+        int staA = a.total_stamina();
+        int staB = b.total_stamina();
+        bool turn = rng() & 1u;
+        while (hpA > 0 && hpB > 0 && (staA > 0 || staB > 0)) {
+            if (turn && staA > 0) {
+                hpB -= a.total_power();
+                --staA;
+                emit(BattleFrame{true, hpA, hpB, staA, staB});
+            } else if (!turn && staB > 0) {
+                hpA -= b.total_power();
+                --staB;
+                emit(BattleFrame{false, hpA, hpB, staA, staB});
+            }
+            turn = rng() & 1u;
+        }
+        return (hpA >= hpB) ? a.id : b.id;
+    }
+
     std::vector<BattleFrame> frames_{};
     std::uint32_t winner_{0};
 };
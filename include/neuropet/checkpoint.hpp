@@ -0,0 +1,238 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "neuropet/int8_spec.hpp" // write_u32/read_u32
+#include <harmonics/serialization.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define NEUROPET_HAS_FSYNC 1
+#else
+#define NEUROPET_HAS_FSYNC 0
+#endif
+
+namespace neuropet {
+
+/**
+ * @brief Immutable view of the full optimizer state at a given step.
+ *
+ * Tensors are shared with the live training state. The trainer clones a
+ * tensor before updating it while a snapshot still references it, so taking
+ * a snapshot only copies pointers.
+ */
+struct TrainingSnapshot {
+    using TensorPtr = std::shared_ptr<const harmonics::HTensor>;
+    std::uint64_t step{0};
+    std::vector<TensorPtr> params{};
+    std::vector<TensorPtr> opt1{}; ///< Adam first moment / RMSProp mean square
+    std::vector<TensorPtr> opt2{}; ///< Adam second moment
+};
+
+/** Training state restored from a checkpoint file. */
+struct TrainingState {
+    std::uint64_t step{0};
+    std::vector<harmonics::HTensor> params{};
+    std::vector<harmonics::HTensor> opt1{};
+    std::vector<harmonics::HTensor> opt2{};
+};
+
+constexpr std::uint32_t TRAINING_CHECKPOINT_VERSION = 1;
+
+/** Return true if ``path`` starts with the ``NPCK`` checkpoint header. */
+inline bool is_training_checkpoint(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4]{};
+    in.read(magic, 4);
+    return in && std::string(magic, 4) == "NPCK";
+}
+
+namespace detail {
+
+/** ``fsync`` the file or directory at ``path``; a no-op without POSIX I/O. */
+inline void fsync_path(const std::string& path, bool directory) {
+#if NEUROPET_HAS_FSYNC
+    int fd = ::open(path.c_str(), directory ? O_RDONLY : O_RDWR);
+    if (fd < 0)
+        throw std::runtime_error("failed to open " + path + " for sync");
+    int rc = ::fsync(fd);
+    ::close(fd);
+    if (rc != 0)
+        throw std::runtime_error("failed to sync " + path);
+#else
+    (void)path;
+    (void)directory;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Serialize a snapshot to ``path`` using write-then-rename.
+ *
+ * The data is written to ``path + ".tmp"``, flushed and ``fsync``ed before it
+ * is renamed over the destination, and the containing directory is synced
+ * afterwards so the rename itself survives a crash. Readers therefore see
+ * either the previous checkpoint or the complete new one.
+ */
+inline void save_training_snapshot(const TrainingSnapshot& snap, const std::string& path) {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("failed to open checkpoint for writing");
+        out.write("NPCK", 4);
+        write_u32(out, TRAINING_CHECKPOINT_VERSION);
+        out.write(reinterpret_cast<const char*>(&snap.step), sizeof(snap.step));
+        write_u32(out, static_cast<std::uint32_t>(snap.params.size()));
+        for (std::size_t i = 0; i < snap.params.size(); ++i) {
+            harmonics::write_tensor(out, *snap.params[i]);
+            harmonics::write_tensor(out, *snap.opt1[i]);
+            harmonics::write_tensor(out, *snap.opt2[i]);
+        }
+        out.flush();
+        if (!out)
+            throw std::runtime_error("failed to write checkpoint");
+    }
+    detail::fsync_path(tmp, false);
+    std::filesystem::rename(tmp, path);
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    detail::fsync_path(dir.empty() ? std::string(".") : dir.string(), true);
+}
+
+/** Load a checkpoint written by ``save_training_snapshot``. */
+inline TrainingState load_training_state(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    in.read(magic, 4);
+    if (!in || std::string(magic, 4) != "NPCK")
+        throw std::runtime_error("invalid checkpoint file");
+    if (read_u32(in) != TRAINING_CHECKPOINT_VERSION)
+        throw std::runtime_error("unsupported checkpoint version");
+    TrainingState st;
+    in.read(reinterpret_cast<char*>(&st.step), sizeof(st.step));
+    std::uint32_t count = read_u32(in);
+    st.params.resize(count);
+    st.opt1.resize(count);
+    st.opt2.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        st.params[i] = harmonics::read_tensor(in);
+        st.opt1[i] = harmonics::read_tensor(in);
+        st.opt2[i] = harmonics::read_tensor(in);
+    }
+    if (!in)
+        throw std::runtime_error("failed to read checkpoint");
+    return st;
+}
+
+/**
+ * @brief Persist snapshots on a background thread.
+ *
+ * ``submit`` never blocks on I/O: it replaces any snapshot still waiting to be
+ * written with the newer one. ``flush`` waits until the most recently
+ * submitted snapshot is on disk.
+ */
+class CheckpointWriter {
+  public:
+    explicit CheckpointWriter(std::string path) : path_{std::move(path)} {
+        worker_ = std::thread([this]() { run(); });
+    }
+
+    ~CheckpointWriter() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (worker_.joinable())
+            worker_.join();
+    }
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /** Queue a snapshot for writing, superseding any pending one. */
+    void submit(TrainingSnapshot snap) {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            pending_ = std::move(snap);
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * Return true while a snapshot is queued or being written. Once this
+     * returns false the writer holds no references to training tensors.
+     */
+    bool in_flight() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return pending_.has_value() || writing_;
+    }
+
+    /** Block until every submitted snapshot has been written. */
+    void flush() {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [this]() { return !pending_ && !writing_; });
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+    /** Number of checkpoints written so far. */
+    std::size_t written() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return written_;
+    }
+
+  private:
+    void run() {
+        std::unique_lock<std::mutex> lk(m_);
+        for (;;) {
+            cv_.wait(lk, [this]() { return stop_ || pending_.has_value(); });
+            if (!pending_)
+                return;
+            TrainingSnapshot snap = std::move(*pending_);
+            pending_.reset();
+            writing_ = true;
+            lk.unlock();
+            std::exception_ptr err;
+            try {
+                save_training_snapshot(snap, path_);
+            } catch (...) {
+                err = std::current_exception();
+            }
+            snap = {}; // release tensor references before reporting idle
+            lk.lock();
+            writing_ = false;
+            if (err)
+                error_ = err;
+            else
+                ++written_;
+            cv_.notify_all();
+        }
+    }
+
+    std::string path_{};
+    mutable std::mutex m_{};
+    std::condition_variable cv_{};
+    std::optional<TrainingSnapshot> pending_{};
+    bool writing_{false};
+    bool stop_{false};
+    std::size_t written_{0};
+    std::exception_ptr error_{};
+    std::thread worker_{};
+};
+
+} // namespace neuropet
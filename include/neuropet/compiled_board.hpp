@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "neuropet/battle.hpp"
+
+namespace neuropet {
+
+/**
+ * @brief Board layout compiled for constant-time fight resolution.
+ *
+ * Movement in ``BattleEngine::fight`` only depends on the board and on which
+ * creature moves first, so the constructor replays both approach walks once
+ * and records the turn of every hazard hit and the contact turn. Once the
+ * creatures are adjacent they attack in strict alternation and the only
+ * block that can ever be active is a single one raised by a creature out of
+ * stamina. The remaining fight therefore reduces to counting attacks, which
+ * ``fight`` resolves arithmetically. Winners are identical to the reference
+ * engine for the board the object was compiled from.
+ */
+class CompiledBoard {
+  public:
+    explicit CompiledBoard(const BattleEngine& engine) {
+        start_a_ = engine.tile_at(0, 0) == BattleEngine::Tile::HAZARD ? 1 : 0;
+        start_b_ = engine.tile_at(7, 7) == BattleEngine::Tile::HAZARD ? 1 : 0;
+        for (int g = 0; g < 2; ++g) {
+            auto plan = engine.plan_approach(g == 0);
+            Side& side = sides_[g];
+            side.contact = plan.contact;
+            side.stuck = plan.stuck;
+            side.a_attacks_first = plan.a_first == (plan.contact % 2 == 0);
+            for (std::size_t t = 0; t < plan.hazard.size(); ++t) {
+                bool a_moves = plan.a_first == (t % 2 == 0);
+                auto& hits = a_moves ? side.hits_a : side.hits_b;
+                for (std::int32_t k = 0; k < plan.hazard[t]; ++k)
+                    hits.push_back(static_cast<std::uint32_t>(t));
+            }
+        }
+    }
+
+    /** Same result as ``BattleEngine::fight`` on the compiled board. */
+    template <class Creature = CreatureStats>
+    std::uint32_t fight(const Creature& a, const Creature& b, std::uint32_t seed = 0) const {
+        return resolve(a.id, a.total_power(), a.total_defense(), a.total_stamina(), b.id,
+                       b.total_power(), b.total_defense(), b.total_stamina(), seed);
+    }
+
+    /** Same results as ``BattleEngine::fight_batch`` on the compiled board. */
+    std::vector<std::uint32_t> fight_batch(const BattleBatch& batch) const {
+        std::vector<std::uint32_t> winners(batch.size());
+        for (std::size_t i = 0; i < batch.size(); ++i)
+            winners[i] = resolve(batch.id_a[i], batch.power_a[i], batch.defense_a[i],
+                                 batch.stamina_a[i], batch.id_b[i], batch.power_b[i],
+                                 batch.defense_b[i], batch.stamina_b[i], batch.seed[i]);
+        return winners;
+    }
+
+    /** Resolve a fight from pre-aggregated stats. */
+    std::uint32_t resolve(std::uint32_t id_a, int power_a, int defense_a, int stamina_a,
+                          std::uint32_t id_b, int power_b, int defense_b, int stamina_b,
+                          std::uint32_t seed = 0) const {
+        std::int64_t hpA = static_cast<std::int64_t>(defense_a) - start_a_;
+        std::int64_t hpB = static_cast<std::int64_t>(defense_b) - start_b_;
+        if (hpA <= 0 || hpB <= 0 || (stamina_a <= 0 && stamina_b <= 0))
+            return hpA >= hpB ? id_a : id_b;
+
+        std::uint32_t s = seed ? seed : (id_a ^ id_b);
+        const Side& side = sides_[s & 1u];
+
+        // Hazards along the approach: the first creature to hit zero loses.
+        std::uint64_t death_a = death_turn(side.hits_a, hpA);
+        std::uint64_t death_b = death_turn(side.hits_b, hpB);
+        if (death_a != kNever || death_b != kNever)
+            return death_a < death_b ? id_b : id_a;
+        if (side.stuck)
+            throw std::runtime_error("creatures can never meet on this board");
+        hpA -= static_cast<std::int64_t>(side.hits_a.size());
+        hpB -= static_cast<std::int64_t>(side.hits_b.size());
+
+        Fighter f{hpA, power_a, stamina_a};
+        Fighter sec{hpB, power_b, stamina_b};
+        if (!side.a_attacks_first)
+            std::swap(f, sec);
+        combat(f, sec);
+        if (!side.a_attacks_first)
+            std::swap(f, sec);
+        return f.hp >= sec.hp ? id_a : id_b;
+    }
+
+  private:
+    static constexpr std::uint64_t kNever = std::numeric_limits<std::uint64_t>::max();
+
+    struct Side {
+        std::vector<std::uint32_t> hits_a{}; ///< approach turns on which A loses 1 hp
+        std::vector<std::uint32_t> hits_b{};
+        std::size_t contact{0};
+        bool stuck{false};
+        bool a_attacks_first{true};
+    };
+
+    struct Fighter {
+        std::int64_t hp;
+        std::int64_t power;
+        std::int64_t stamina;
+    };
+
+    static std::uint64_t death_turn(const std::vector<std::uint32_t>& hits, std::int64_t hp) {
+        if (hp > static_cast<std::int64_t>(hits.size()))
+            return kNever;
+        return hits[static_cast<std::size_t>(hp - 1)];
+    }
+
+    /** Damage dealt by the first ``n`` attacks, ``full`` of them unblocked. */
+    static std::int64_t damage(std::int64_t n, std::int64_t power, std::int64_t full) {
+        std::int64_t unblocked = std::min(n, full);
+        return unblocked * power + (n - unblocked) * std::max<std::int64_t>(power - 1, 0);
+    }
+
+    /** Smallest attack count in ``[1, stamina]`` dealing at least ``hp``; 0 if none. */
+    static std::int64_t kill_after(std::int64_t hp, std::int64_t power, std::int64_t full,
+                                   std::int64_t stamina) {
+        if (power <= 0)
+            return 0;
+        if (hp <= full * power)
+            return (hp + power - 1) / power;
+        std::int64_t reduced = power - 1;
+        if (reduced <= 0)
+            return 0;
+        std::int64_t n = full + (hp - full * power + reduced - 1) / reduced;
+        return n <= stamina ? n : 0;
+    }
+
+    /**
+     * Attack phase with ``f`` moving first. ``f`` attacks on even turns and
+     * ``s`` on odd turns. While both have stamina every hit lands in full.
+     * After one runs dry it blocks once per turn, so each following attack
+     * of the other is reduced by exactly one.
+     */
+    static void combat(Fighter& f, Fighter& s) {
+        std::int64_t sta_f = std::max<std::int64_t>(f.stamina, 0);
+        std::int64_t sta_s = std::max<std::int64_t>(s.stamina, 0);
+        std::int64_t full_f = std::min(sta_f, sta_s + 1);
+        std::int64_t full_s = std::min(sta_s, sta_f);
+
+        std::int64_t kf = kill_after(s.hp, f.power, full_f, sta_f);
+        std::int64_t ks = kill_after(f.hp, s.power, full_s, sta_s);
+        std::int64_t turn_f = kf ? 2 * (kf - 1) : std::numeric_limits<std::int64_t>::max();
+        std::int64_t turn_s = ks ? 2 * ks - 1 : std::numeric_limits<std::int64_t>::max();
+
+        std::int64_t hits_f = sta_f;
+        std::int64_t hits_s = sta_s;
+        if (turn_f < turn_s) {
+            hits_f = kf;
+            hits_s = std::min(kf - 1, sta_s);
+        } else if (turn_s < turn_f) {
+            hits_s = ks;
+            hits_f = std::min(ks, sta_f);
+        }
+        s.hp -= damage(hits_f, f.power, full_f);
+        f.hp -= damage(hits_s, s.power, full_s);
+    }
+
+    std::int64_t start_a_{0};
+    std::int64_t start_b_{0};
+    Side sides_[2]{};
+};
+
+} // namespace neuropet
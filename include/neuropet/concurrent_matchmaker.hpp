@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "neuropet/battle.hpp"
+#include "neuropet/match_ledger.hpp"
+#include "neuropet/mpmc_ring.hpp"
+#include "neuropet/parallel.hpp"
+#include "neuropet/ring_queue.hpp"
+
+namespace neuropet {
+
+/** Tuning knobs for ``ConcurrentMatchmaker``. */
+struct ConcurrentMatchmakerOptions {
+    /// Creatures buffered between producers and the pairing thread.
+    std::size_t capacity{1u << 16};
+    /// Threads running fights; zero uses all cores.
+    unsigned workers{0};
+    /// Seed passed to every fight, as in ``Matchmaker::try_match``.
+    std::uint32_t seed{0};
+    /// Optional shared cache of fight outcomes.
+    BattleMemo* memo{nullptr};
+};
+
+/**
+ * @brief FIFO matchmaker accepting creatures from many threads.
+ *
+ * ``enqueue`` is lock-free: creatures go into a bounded ring consumed by a
+ * single pairing thread, which numbers each pair as it is formed. Worker
+ * threads run the fights in parallel and a reorder stage hands the results
+ * to the ledger strictly in pair order, so the ledger matches what
+ * ``Matchmaker`` records for the same queue order no matter how many workers
+ * run or in which order fights finish.
+ *
+ * Pairs move to the workers and results to the reorder stage in batches,
+ * each under its own lock, so cheap fights do not serialize on a shared
+ * mutex. An idle pairing thread sleeps until a producer sees its idle flag;
+ * both sides fence before checking the other's state, so a wakeup is never
+ * lost.
+ */
+class ConcurrentMatchmaker {
+  public:
+    explicit ConcurrentMatchmaker(const BattleEngine& engine = BattleEngine(),
+                                  MatchLedger* ledger = nullptr,
+                                  ConcurrentMatchmakerOptions opts = {})
+        : engine_{engine}, ledger_{ledger}, opts_{opts}, ring_{opts.capacity} {
+        worker_count_ = resolve_thread_count(opts_.workers);
+        for (unsigned i = 0; i < worker_count_; ++i)
+            workers_.emplace_back([this]() { work(); });
+        pairer_ = std::thread([this]() { pair(); });
+    }
+
+    /** Finishes every queued match before returning. */
+    ~ConcurrentMatchmaker() {
+        drain();
+        stop_.store(true);
+        {
+            std::lock_guard<std::mutex> lk(idle_m_);
+            idle_cv_.notify_all();
+        }
+        pairer_.join();
+        {
+            std::lock_guard<std::mutex> lk(jobs_m_);
+            work_cv_.notify_all();
+        }
+        for (auto& t : workers_)
+            t.join();
+    }
+
+    ConcurrentMatchmaker(const ConcurrentMatchmaker&) = delete;
+    ConcurrentMatchmaker& operator=(const ConcurrentMatchmaker&) = delete;
+
+    /** Queue a creature; returns false if the ring is full. Lock-free. */
+    bool try_enqueue(const CompactCreature& creature) {
+        if (!ring_.try_push(creature))
+            return false;
+        enqueued_.fetch_add(1, std::memory_order_release);
+        // Pairs with the fence in ``pair``: either the pairing thread sees
+        // this creature before sleeping or this thread sees it idle.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (pairer_idle_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lk(idle_m_);
+            idle_cv_.notify_one();
+        }
+        return true;
+    }
+
+    /** Queue a creature, yielding while the ring is full. */
+    void enqueue(const CompactCreature& creature) {
+        while (!try_enqueue(creature))
+            std::this_thread::yield();
+    }
+
+    void enqueue(const CreatureStats& creature) { enqueue(CompactCreature(creature)); }
+
+    /**
+     * Block until every creature enqueued before the call has been paired and
+     * its result recorded. An odd creature out keeps waiting for a partner.
+     */
+    void drain() {
+        std::uint64_t target = enqueued_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lk(commit_m_);
+        done_cv_.wait(lk, [&]() {
+            return popped_.load(std::memory_order_acquire) >= target &&
+                   committed_ == issued_.load(std::memory_order_acquire);
+        });
+    }
+
+    /** Matches recorded so far. */
+    std::uint64_t matches() const {
+        std::lock_guard<std::mutex> lk(commit_m_);
+        return committed_;
+    }
+
+    /** Creatures enqueued but not yet paired. */
+    std::size_t pending() const {
+        std::uint64_t issued = issued_.load(std::memory_order_acquire);
+        std::uint64_t queued = enqueued_.load(std::memory_order_acquire);
+        // A creature can be paired before its producer bumps the counter.
+        return queued > 2 * issued ? static_cast<std::size_t>(queued - 2 * issued) : 0;
+    }
+
+  private:
+    /// Pairs handed over or taken per lock acquisition.
+    static constexpr std::size_t kBatch = 64;
+
+    struct Job {
+        std::uint64_t seq{0};
+        CompactCreature a{};
+        CompactCreature b{};
+    };
+
+    struct Result {
+        std::uint64_t seq{0};
+        std::uint32_t winner{0};
+        std::uint32_t loser{0};
+    };
+
+    void pair() {
+        std::optional<CompactCreature> held;
+        std::vector<Job> batch;
+        batch.reserve(kBatch);
+        std::uint64_t seq = 0;
+        std::uint64_t popped = 0;
+        CompactCreature c;
+        for (;;) {
+            std::size_t got = 0;
+            while (batch.size() < kBatch && ring_.try_pop(c)) {
+                ++got;
+                if (!held) {
+                    held = c;
+                } else {
+                    batch.push_back(Job{seq++, *held, c});
+                    held.reset();
+                }
+            }
+            if (got) {
+                publish(batch, seq, popped += got);
+                continue;
+            }
+            std::unique_lock<std::mutex> lk(idle_m_);
+            pairer_idle_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            idle_cv_.wait(lk, [this]() { return stop_.load() || ring_.size() != 0; });
+            pairer_idle_.store(false, std::memory_order_relaxed);
+            if (stop_.load() && ring_.size() == 0)
+                return;
+        }
+    }
+
+    /** Hand ``batch`` to the workers and publish the pairing progress. */
+    void publish(std::vector<Job>& batch, std::uint64_t issued, std::uint64_t popped) {
+        issued_.store(issued, std::memory_order_release);
+        popped_.store(popped, std::memory_order_release);
+        if (!batch.empty()) {
+            std::lock_guard<std::mutex> lk(jobs_m_);
+            for (const auto& job : batch)
+                jobs_.push_back(job);
+            if (batch.size() > 1)
+                work_cv_.notify_all();
+            else
+                work_cv_.notify_one();
+        }
+        batch.clear();
+        std::lock_guard<std::mutex> lk(commit_m_);
+        done_cv_.notify_all();
+    }
+
+    void work() {
+        std::vector<Job> batch;
+        std::vector<Result> results;
+        batch.reserve(kBatch);
+        results.reserve(kBatch);
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(jobs_m_);
+                work_cv_.wait(lk, [this]() { return stop_.load() || !jobs_.empty(); });
+                if (jobs_.empty())
+                    return;
+                // Leave work for the other workers when the queue is short.
+                std::size_t take =
+                    std::min(kBatch, (jobs_.size() + worker_count_ - 1) / worker_count_);
+                for (std::size_t i = 0; i < take; ++i) {
+                    batch.push_back(jobs_.front());
+                    jobs_.pop_front();
+                }
+            }
+            for (const Job& job : batch) {
+                std::uint32_t winner = opts_.memo
+                                           ? opts_.memo->fight(engine_, job.a, job.b, opts_.seed)
+                                           : engine_.fight(job.a, job.b, opts_.seed);
+                results.push_back({job.seq, winner, winner == job.a.id ? job.b.id : job.a.id});
+            }
+            batch.clear();
+            commit(results);
+            results.clear();
+        }
+    }
+
+    /** Slot ``results`` into the reorder buffer and record every ready prefix. */
+    void commit(const std::vector<Result>& results) {
+        std::lock_guard<std::mutex> lk(commit_m_);
+        for (const Result& r : results) {
+            std::size_t slot = static_cast<std::size_t>(r.seq - committed_);
+            if (finished_.size() <= slot)
+                finished_.resize(slot + 1);
+            finished_[slot] = std::make_pair(r.winner, r.loser);
+        }
+        std::uint64_t before = committed_;
+        while (!finished_.empty() && finished_.front()) {
+            if (ledger_)
+                ledger_->record_result(finished_.front()->first, finished_.front()->second);
+            finished_.pop_front();
+            ++committed_;
+        }
+        if (committed_ != before)
+            done_cv_.notify_all();
+    }
+
+    BattleEngine engine_{};
+    MatchLedger* ledger_{};
+    ConcurrentMatchmakerOptions opts_{};
+    MpmcRing<CompactCreature> ring_;
+    std::atomic<std::uint64_t> enqueued_{0};
+    std::atomic<std::uint64_t> popped_{0};
+    std::atomic<std::uint64_t> issued_{0};
+    std::atomic<bool> pairer_idle_{false};
+    std::atomic<bool> stop_{false};
+    std::size_t worker_count_{1};
+
+    /// Guards the pairing thread's sleep.
+    std::mutex idle_m_{};
+    std::condition_variable idle_cv_{};
+    /// Guards ``jobs_``.
+    std::mutex jobs_m_{};
+    std::condition_variable work_cv_{};
+    RingQueue<Job> jobs_{};
+    /// Guards the reorder buffer, ``committed_`` and the ledger.
+    mutable std::mutex commit_m_{};
+    std::condition_variable done_cv_{};
+    std::uint64_t committed_{0};
+    std::deque<std::optional<std::pair<std::uint32_t, std::uint32_t>>> finished_{};
+
+    std::thread pairer_{};
+    std::vector<std::thread> workers_{};
+};
+
+} // namespace neuropet
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <blake3.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace neuropet {
+
+/**
+ * @brief 32-byte digest held by value.
+ *
+ * Checkpoint roots travel through the chain, validator and aggregator as
+ * ``Digest32`` so lookups compare 32 bytes without allocating. Hex strings
+ * are only produced and parsed at JSON-RPC and CLI boundaries via ``hex``
+ * and ``from_hex``.
+ */
+struct Digest32 {
+    std::array<std::uint8_t, 32> bytes{};
+
+    static Digest32 from_bytes(const void* data) {
+        Digest32 d;
+        std::memcpy(d.bytes.data(), data, d.bytes.size());
+        return d;
+    }
+
+    /** Parse exactly 64 hex digits of either case; false on any other input. */
+    static bool parse_hex(const std::string& hex, Digest32& out) {
+        if (hex.size() != 64)
+            return false;
+        for (std::size_t i = 0; i < 32; ++i) {
+            int hi = nibble(hex[2 * i]);
+            int lo = nibble(hex[2 * i + 1]);
+            if (hi < 0 || lo < 0)
+                return false;
+            out.bytes[i] = static_cast<std::uint8_t>((hi << 4) | lo);
+        }
+        return true;
+    }
+
+    static Digest32 from_hex(const std::string& hex) {
+        Digest32 d;
+        if (!parse_hex(hex, d))
+            throw std::runtime_error("invalid 32-byte hex digest");
+        return d;
+    }
+
+    /**
+     * Digest of a root as given by callers: 64 hex digits are decoded, any
+     * other label is hashed with BLAKE3 so it still maps to a stable key.
+     */
+    static Digest32 from_root(const std::string& root) {
+        Digest32 d;
+        if (parse_hex(root, d))
+            return d;
+        blake3_hasher hasher;
+        blake3_hasher_init(&hasher);
+        blake3_hasher_update(&hasher, root.data(), root.size());
+        blake3_hasher_finalize(&hasher, d.bytes.data(), d.bytes.size());
+        return d;
+    }
+
+    /** Lowercase hex, matching ``to_hex``. */
+    std::string hex() const {
+        static const char* digits = "0123456789abcdef";
+        std::string out(64, '0');
+        for (std::size_t i = 0; i < 32; ++i) {
+            out[2 * i] = digits[bytes[i] >> 4];
+            out[2 * i + 1] = digits[bytes[i] & 0xf];
+        }
+        return out;
+    }
+
+    bool operator==(const Digest32& o) const { return bytes == o.bytes; }
+    bool operator!=(const Digest32& o) const { return bytes != o.bytes; }
+    bool operator<(const Digest32& o) const { return bytes < o.bytes; }
+
+  private:
+    static int nibble(char c) {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+};
+
+namespace detail {
+
+/** Per-process key of ``Digest32Hash``. */
+inline std::uint64_t digest_hash_seed() {
+    static const std::uint64_t seed = [] {
+        std::random_device rd;
+        return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+    }();
+    return seed;
+}
+
+} // namespace detail
+
+/**
+ * Hash for unordered containers. Roots arrive from peers unverified, so all
+ * 32 bytes are mixed under a per-process seed; otherwise a peer could choose
+ * roots that share a bucket and turn lookups into linear scans.
+ */
+struct Digest32Hash {
+    std::size_t operator()(const Digest32& d) const {
+        std::uint64_t h = detail::digest_hash_seed();
+        for (std::size_t i = 0; i < d.bytes.size(); i += 8) {
+            std::uint64_t v;
+            std::memcpy(&v, d.bytes.data() + i, sizeof(v));
+            h = (h ^ v) * 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 31;
+        }
+        h *= 0x94D049BB133111EBull;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+};
+
+} // namespace neuropet
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <openssl/evp.h>
+#include <stdexcept>
 #include <vector>
 
 #include "neuropet/int8_spec.hpp"
+#include "neuropet/parallel.hpp"
 
 namespace neuropet {
 
@@ -23,8 +28,34 @@ inline std::array<std::uint8_t, 32> keccak256_bytes(const void* data, std::size_
     return out;
 }
 
-inline HatchTopology derive_topology(const std::array<std::uint8_t, 32>& seed) {
-    auto bits = keccak256_bytes(seed.data(), seed.size());
+/**
+ * Reusable ``keccak256_bytes``. The digest is bound to one context at
+ * construction and every call only resets it, skipping the per-call context
+ * allocation and algorithm lookup of ``EVP_Digest``. Not thread-safe; use one
+ * per worker.
+ */
+class Keccak256Hasher {
+  public:
+    Keccak256Hasher() : ctx_{EVP_MD_CTX_new(), &EVP_MD_CTX_free} {
+        if (!ctx_ || EVP_DigestInit_ex(ctx_.get(), EVP_sha3_256(), nullptr) != 1)
+            throw std::runtime_error("failed to initialise keccak256 context");
+    }
+
+    std::array<std::uint8_t, 32> operator()(const void* data, std::size_t size) {
+        std::array<std::uint8_t, 32> out{};
+        unsigned int outlen = out.size();
+        if (EVP_DigestInit_ex(ctx_.get(), nullptr, nullptr) != 1 ||
+            EVP_DigestUpdate(ctx_.get(), data, size) != 1 ||
+            EVP_DigestFinal_ex(ctx_.get(), out.data(), &outlen) != 1)
+            throw std::runtime_error("keccak256 digest failed");
+        return out;
+    }
+
+  private:
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx_;
+};
+
+inline HatchTopology topology_from_bits(const std::array<std::uint8_t, 32>& bits) {
     static constexpr std::array<std::uint8_t, 4> SIZE_TABLE{32, 48, 64, 96};
     HatchTopology t{};
     std::uint16_t sc =
@@ -40,6 +71,10 @@ inline HatchTopology derive_topology(const std::array<std::uint8_t, 32>& seed) {
     return t;
 }
 
+inline HatchTopology derive_topology(const std::array<std::uint8_t, 32>& seed) {
+    return topology_from_bits(keccak256_bytes(seed.data(), seed.size()));
+}
+
 inline std::uint64_t splitmix64(std::uint64_t& state) {
     std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
     z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
@@ -52,11 +87,90 @@ inline int8_t next_weight(std::uint64_t& state) {
     return static_cast<int8_t>((r >> 2) % 17 - 8);
 }
 
+/**
+ * Write the first ``count`` genesis weights of ``seed`` to ``out``. Output
+ * ``i`` of the splitmix64 stream only depends on ``seed + (i + 1) * gamma``,
+ * so every weight is computed independently; the loop carries no state and
+ * compilers vectorize it. Matches repeated ``next_weight`` calls exactly.
+ */
+inline void generate_genesis_weights(int8_t* out, std::size_t count, std::uint64_t seed,
+                                     std::size_t first = 0) {
+    constexpr std::uint64_t gamma = 0x9E3779B97F4A7C15ULL;
+    std::uint64_t state = seed + static_cast<std::uint64_t>(first) * gamma;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t z = (state += gamma);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        out[i] = static_cast<int8_t>((z >> 2) % 17 - 8);
+    }
+}
+
 inline std::vector<int8_t> generate_genesis_weights(std::size_t count, std::uint64_t seed) {
-    std::uint64_t state = seed;
     std::vector<int8_t> out(count);
-    for (std::size_t i = 0; i < count; ++i)
-        out[i] = next_weight(state);
+    generate_genesis_weights(out.data(), count, seed);
+    return out;
+}
+
+/** One creature of a ``hatch_batch`` call. */
+struct HatchRequest {
+    std::array<std::uint8_t, 32> seed{};
+    std::uint64_t weight_seed{0};
+    std::size_t weight_count{0};
+};
+
+struct HatchResult {
+    HatchTopology topology{};
+    std::vector<int8_t> weights{};
+};
+
+/**
+ * @brief Hatch many creatures at once.
+ *
+ * Result ``i`` equals ``derive_topology(requests[i].seed)`` and
+ * ``generate_genesis_weights(weight_count, weight_seed)`` regardless of
+ * ``threads``. Requests are split into fixed blocks spread across workers;
+ * each block hashes its seeds through one ``Keccak256Hasher`` and fills
+ * the weights of its creatures. Creatures with more than ``weight_slice``
+ * weights are filled afterwards in slices of that size, so a few very large
+ * creatures still spread across all workers.
+ */
+inline std::vector<HatchResult> hatch_batch(const std::vector<HatchRequest>& requests,
+                                            unsigned threads = 0,
+                                            std::size_t weight_slice = 1u << 16) {
+    constexpr std::size_t block = 256;
+    if (weight_slice == 0)
+        weight_slice = 1;
+    std::vector<HatchResult> out(requests.size());
+    parallel_for((requests.size() + block - 1) / block, threads, [&](std::size_t b) {
+        Keccak256Hasher keccak;
+        const std::size_t end = std::min(requests.size(), (b + 1) * block);
+        for (std::size_t i = b * block; i < end; ++i) {
+            const auto& seed = requests[i].seed;
+            out[i].topology = topology_from_bits(keccak(seed.data(), seed.size()));
+            out[i].weights.resize(requests[i].weight_count);
+            if (requests[i].weight_count <= weight_slice)
+                generate_genesis_weights(out[i].weights.data(), requests[i].weight_count,
+                                         requests[i].weight_seed);
+        }
+    });
+
+    struct Slice {
+        std::size_t creature;
+        std::size_t first;
+    };
+    std::vector<Slice> slices;
+    for (std::size_t i = 0; i < requests.size(); ++i)
+        if (requests[i].weight_count > weight_slice)
+            for (std::size_t f = 0; f < requests[i].weight_count; f += weight_slice)
+                slices.push_back({i, f});
+    parallel_for(slices.size(), threads, [&](std::size_t k) {
+        const Slice& s = slices[k];
+        const HatchRequest& r = requests[s.creature];
+        std::size_t n = std::min(weight_slice, r.weight_count - s.first);
+        generate_genesis_weights(out[s.creature].weights.data() + s.first, n, r.weight_seed,
+                                 s.first);
+    });
     return out;
 }
 
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "neuropet/match_ledger.hpp"
+#include "neuropet/rating.hpp"
+
+namespace neuropet {
+
+/** Per-creature summary maintained by ``LedgerIndex``. */
+struct CreatureRecord {
+    std::uint32_t wins{0};
+    std::uint32_t losses{0};
+    double rating{1500.0};
+    /// Offsets into ``MatchLedger::results()`` of every battle fought.
+    std::vector<std::uint32_t> results{};
+};
+
+/** Leaderboard row returned by ``LedgerIndex::top``. */
+struct LeaderboardEntry {
+    std::uint32_t id{0};
+    double rating{0.0};
+};
+
+/**
+ * @brief Incremental indexes over a stream of match results.
+ *
+ * ``add`` updates both creatures' win/loss counters, Elo ratings and result
+ * lists in amortized O(1), plus an O(log n) reposition in the rating-ordered
+ * leaderboard, so top-K queries never rescan the ledger. Ratings use the
+ * same formula and constants as ``EloRatings``.
+ */
+class LedgerIndex {
+  public:
+    explicit LedgerIndex(double initial = 1500.0, double k = 32.0) : initial_{initial}, k_{k} {}
+
+    /** Index ``r`` stored at ``offset`` in the ledger. */
+    void add(const MatchResult& r, std::uint32_t offset) {
+        CreatureRecord& w = touch(r.winner);
+        CreatureRecord& l = touch(r.loser);
+        board_.erase({w.rating, r.winner});
+        board_.erase({l.rating, r.loser});
+        double delta = k_ * (1.0 - EloRatings::expected_score(w.rating, l.rating));
+        w.rating += delta;
+        l.rating -= delta;
+        ++w.wins;
+        ++l.losses;
+        w.results.push_back(offset);
+        l.results.push_back(offset);
+        board_.insert({w.rating, r.winner});
+        board_.insert({l.rating, r.loser});
+    }
+
+    /** Record for ``id`` or ``nullptr`` if it never fought. */
+    const CreatureRecord* find(std::uint32_t id) const {
+        auto it = records_.find(id);
+        return it == records_.end() ? nullptr : &it->second;
+    }
+
+    double rating(std::uint32_t id) const {
+        const CreatureRecord* rec = find(id);
+        return rec ? rec->rating : initial_;
+    }
+
+    /** Highest rated creatures, best first; ties go to the lower id. */
+    std::vector<LeaderboardEntry> top(std::size_t k) const {
+        std::vector<LeaderboardEntry> out;
+        out.reserve(std::min(k, board_.size()));
+        for (auto it = board_.begin(); it != board_.end() && out.size() < k; ++it)
+            out.push_back({it->second, it->first});
+        return out;
+    }
+
+    /** Number of creatures with at least one result. */
+    std::size_t creatures() const { return records_.size(); }
+
+    void clear() {
+        records_.clear();
+        board_.clear();
+    }
+
+  private:
+    struct ByRating {
+        bool operator()(const std::pair<double, std::uint32_t>& a,
+                        const std::pair<double, std::uint32_t>& b) const {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        }
+    };
+
+    CreatureRecord& touch(std::uint32_t id) {
+        auto [it, inserted] = records_.try_emplace(id);
+        if (inserted) {
+            it->second.rating = initial_;
+            board_.insert({initial_, id});
+        }
+        return it->second;
+    }
+
+    double initial_{1500.0};
+    double k_{32.0};
+    std::unordered_map<std::uint32_t, CreatureRecord> records_{};
+    std::set<std::pair<double, std::uint32_t>, ByRating> board_{};
+};
+
+/** ``MatchLedger`` that keeps a ``LedgerIndex`` current on every result. */
+class IndexedLedger : public MatchLedger {
+  public:
+    std::uint32_t record_result(std::uint32_t winner, std::uint32_t loser) override {
+        std::uint32_t id = MatchLedger::record_result(winner, loser);
+        index_.add(results_.back(), static_cast<std::uint32_t>(results_.size() - 1));
+        return id;
+    }
+
+    const LedgerIndex& index() const { return index_; }
+
+    /** Record for ``id`` or ``nullptr`` if it never fought. */
+    const CreatureRecord* creature(std::uint32_t id) const { return index_.find(id); }
+
+    /** Highest rated creatures, best first. */
+    std::vector<LeaderboardEntry> top(std::size_t k) const { return index_.top(k); }
+
+    /**
+     * Wins of ``a`` and ``b`` against each other, found by walking the
+     * shorter of the two result lists.
+     */
+    std::pair<std::uint32_t, std::uint32_t> head_to_head(std::uint32_t a, std::uint32_t b) const {
+        const CreatureRecord* ra = index_.find(a);
+        const CreatureRecord* rb = index_.find(b);
+        if (!ra || !rb)
+            return {0, 0};
+        const CreatureRecord* walk = ra->results.size() <= rb->results.size() ? ra : rb;
+        std::uint32_t wins_a = 0;
+        std::uint32_t wins_b = 0;
+        for (std::uint32_t off : walk->results) {
+            const MatchResult& r = results_[off];
+            if (r.winner == a && r.loser == b)
+                ++wins_a;
+            else if (r.winner == b && r.loser == a)
+                ++wins_b;
+        }
+        return {wins_a, wins_b};
+    }
+
+  private:
+    LedgerIndex index_{};
+};
+
+} // namespace neuropet
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "neuropet/indexed_ledger.hpp"
+#include "neuropet/match_ledger.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NEUROPET_HAS_MMAP 1
+#else
+#define NEUROPET_HAS_MMAP 0
+#endif
+
+namespace neuropet {
+
+/**
+ * @brief Durable ``MatchLedger`` backed by an append-only memory-mapped log.
+ *
+ * The file holds a 16 byte header followed by a preallocated array of 16 byte
+ * records ``{battle_id, winner, loser, checksum}``. Appending is a single
+ * copy into the mapping. Every ``sync_interval`` records the pages holding
+ * the records appended since the previous sync are written with ``MS_SYNC``,
+ * so a crash loses at most the last ``sync_interval - 1`` records; ``flush``
+ * syncs everything appended so far. A failed sync throws after the record
+ * has been appended and indexed, and the next sync retries its pages. On open the records are scanned
+ * sequentially to rebuild ``results()`` and the ``LedgerIndex``. The scan
+ * stops at the first record whose checksum or battle id does not follow the
+ * previous one, and every record after it is zeroed: pages can reach the disk
+ * out of order, so valid-looking records beyond a torn one are stale and must
+ * not be joined onto the log by later appends.
+ */
+class MappedMatchLedger : public MatchLedger {
+  public:
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t HEADER_SIZE = 16;
+    static constexpr std::size_t RECORD_SIZE = 16;
+
+    explicit MappedMatchLedger(const std::string& path, std::size_t initial_capacity = 1u << 16,
+                               std::size_t sync_interval = 4096)
+        : path_{path}, sync_interval_{sync_interval ? sync_interval : 1} {
+#if NEUROPET_HAS_MMAP
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error("failed to open ledger file");
+        try {
+            struct stat st {};
+            if (::fstat(fd_, &st) != 0)
+                throw std::runtime_error("failed to stat ledger file");
+            std::size_t size = static_cast<std::size_t>(st.st_size);
+            if (size < HEADER_SIZE) {
+                size = HEADER_SIZE + std::max<std::size_t>(initial_capacity, 1) * RECORD_SIZE;
+                resize_file(size);
+                map(size);
+                std::memcpy(base_, "NPML", 4);
+                put(base_ + 4, VERSION);
+                put(base_ + 8, static_cast<std::uint32_t>(RECORD_SIZE));
+            } else {
+                map(size);
+                if (std::memcmp(base_, "NPML", 4) != 0 || get(base_ + 4) != VERSION ||
+                    get(base_ + 8) != RECORD_SIZE)
+                    throw std::runtime_error("invalid ledger file");
+            }
+            recover();
+        } catch (...) {
+            if (base_)
+                unmap();
+            ::close(fd_);
+            throw;
+        }
+#else
+        (void)initial_capacity;
+        throw std::runtime_error("memory-mapped ledger requires POSIX mmap");
+#endif
+    }
+
+    ~MappedMatchLedger() override {
+#if NEUROPET_HAS_MMAP
+        if (base_) {
+            ::msync(base_, mapped_, MS_SYNC);
+            unmap();
+        }
+        if (fd_ >= 0)
+            ::close(fd_);
+#endif
+    }
+
+    MappedMatchLedger(const MappedMatchLedger&) = delete;
+    MappedMatchLedger& operator=(const MappedMatchLedger&) = delete;
+
+    std::uint32_t record_result(std::uint32_t winner, std::uint32_t loser) override {
+#if NEUROPET_HAS_MMAP
+        if (count_ == capacity())
+            grow();
+        MatchResult r{next_id_, winner, loser};
+        write_record(record_ptr(count_), r);
+        ++count_;
+        ++next_id_;
+        results_.push_back(r);
+        index_.add(r, static_cast<std::uint32_t>(results_.size() - 1));
+        if (count_ - synced_ >= sync_interval_)
+            sync_records();
+        return r.battle_id;
+#else
+        (void)winner;
+        (void)loser;
+        return 0;
+#endif
+    }
+
+    /** Block until every appended record is on disk. */
+    void flush() {
+#if NEUROPET_HAS_MMAP
+        if (!sync_pages(base_, mapped_))
+            throw std::runtime_error("failed to sync ledger file");
+        synced_ = count_;
+#endif
+    }
+
+    /** Indexes rebuilt on open and kept current on every append. */
+    const LedgerIndex& index() const { return index_; }
+
+    /** Records that fit before the file has to grow. */
+    std::size_t capacity() const { return (mapped_ - HEADER_SIZE) / RECORD_SIZE; }
+
+    /** Torn records discarded while opening the file. */
+    std::size_t truncated() const { return truncated_; }
+
+    const std::string& path() const { return path_; }
+
+  protected:
+    /** ``msync`` with ``MS_SYNC``; virtual so tests can simulate I/O errors. */
+    virtual bool sync_pages(unsigned char* addr, std::size_t len) {
+#if NEUROPET_HAS_MMAP
+        return ::msync(addr, len, MS_SYNC) == 0;
+#else
+        (void)addr;
+        (void)len;
+        return false;
+#endif
+    }
+
+  private:
+    static void put(unsigned char* p, std::uint32_t v) {
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+
+    static std::uint32_t get(const unsigned char* p) {
+        return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+               (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    /** FNV-1a over the first 12 bytes of a record. */
+    static std::uint32_t checksum(const unsigned char* p) {
+        std::uint32_t h = 2166136261u;
+        for (int i = 0; i < 12; ++i) {
+            h ^= p[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static void write_record(unsigned char* p, const MatchResult& r) {
+        unsigned char buf[RECORD_SIZE];
+        put(buf, r.battle_id);
+        put(buf + 4, r.winner);
+        put(buf + 8, r.loser);
+        put(buf + 12, checksum(buf));
+        std::memcpy(p, buf, RECORD_SIZE);
+    }
+
+    unsigned char* record_ptr(std::size_t i) { return base_ + HEADER_SIZE + i * RECORD_SIZE; }
+
+#if NEUROPET_HAS_MMAP
+    void resize_file(std::size_t size) {
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+            throw std::runtime_error("failed to resize ledger file");
+    }
+
+    void map(std::size_t size) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED)
+            throw std::runtime_error("failed to map ledger file");
+        base_ = static_cast<unsigned char*>(p);
+        mapped_ = size;
+    }
+
+    void unmap() {
+        ::munmap(base_, mapped_);
+        base_ = nullptr;
+        mapped_ = 0;
+    }
+
+    /** ``MS_SYNC`` the pages holding records appended since the last sync. */
+    void sync_records() {
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t begin = (HEADER_SIZE + synced_ * RECORD_SIZE) / page * page;
+        std::size_t end = HEADER_SIZE + count_ * RECORD_SIZE;
+        if (!sync_pages(base_ + begin, end - begin))
+            throw std::runtime_error("failed to sync ledger file");
+        synced_ = count_;
+    }
+
+    void grow() {
+        std::size_t size = HEADER_SIZE + capacity() * 2 * RECORD_SIZE;
+        if (!sync_pages(base_, mapped_))
+            throw std::runtime_error("failed to sync ledger file");
+        synced_ = count_;
+        unmap();
+        resize_file(size);
+        map(size);
+    }
+
+    /** Sequential scan rebuilding the in-memory state; zeroes everything after it. */
+    void recover() {
+        std::size_t cap = capacity();
+        std::uint32_t expected = 1;
+        while (count_ < cap) {
+            const unsigned char* p = record_ptr(count_);
+            if (get(p) != expected || get(p + 12) != checksum(p))
+                break;
+            MatchResult r{get(p), get(p + 4), get(p + 8)};
+            results_.push_back(r);
+            index_.add(r, static_cast<std::uint32_t>(count_));
+            ++count_;
+            ++expected;
+        }
+        next_id_ = expected;
+        static const unsigned char zero[RECORD_SIZE] = {};
+        for (std::size_t i = count_; i < cap; ++i) {
+            unsigned char* p = record_ptr(i);
+            if (std::memcmp(p, zero, RECORD_SIZE) == 0)
+                continue;
+            std::memset(p, 0, RECORD_SIZE);
+            ++truncated_;
+        }
+        if (truncated_ && !sync_pages(base_, mapped_))
+            throw std::runtime_error("failed to sync ledger file");
+        synced_ = count_;
+    }
+
+    int fd_{-1};
+#endif
+
+    std::string path_{};
+    std::size_t sync_interval_{4096};
+    unsigned char* base_{nullptr};
+    std::size_t mapped_{HEADER_SIZE};
+    std::size_t count_{0};
+    std::size_t synced_{0};
+    std::size_t truncated_{0};
+    LedgerIndex index_{};
+};
+
+} // namespace neuropet
@@ -0,0 +1,457 @@
+#pragma once
+
+#include <algorithm>
+#include <blake3.h>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "neuropet/digest32.hpp"
+#include "neuropet/parallel.hpp"
+#include "neuropet/proof_system.hpp"
+
+namespace neuropet {
+
+/** Default bytes per Merkle leaf; larger tensors are split into several leaves. */
+constexpr std::size_t kMerkleChunkSize = std::size_t{1} << 16;
+
+namespace detail {
+
+/** ``BLAKE3(0x00 || bytes)``: hash of one chunk of a tensor. */
+inline Digest32 merkle_chunk(const int8_t* data, std::size_t size) {
+    const std::uint8_t tag = 0x00;
+    Digest32 d;
+    blake3_hasher hasher;
+    blake3_hasher_init(&hasher);
+    blake3_hasher_update(&hasher, &tag, 1);
+    if (size)
+        blake3_hasher_update(&hasher, data, size);
+    blake3_hasher_finalize(&hasher, d.bytes.data(), d.bytes.size());
+    return d;
+}
+
+/** ``BLAKE3(0x01 || left || right)``: interior node. */
+inline Digest32 merkle_node(const Digest32& left, const Digest32& right) {
+    std::uint8_t buf[65];
+    buf[0] = 0x01;
+    std::copy(left.bytes.begin(), left.bytes.end(), buf + 1);
+    std::copy(right.bytes.begin(), right.bytes.end(), buf + 33);
+    Digest32 d;
+    blake3_hasher hasher;
+    blake3_hasher_init(&hasher);
+    blake3_hasher_update(&hasher, buf, sizeof(buf));
+    blake3_hasher_finalize(&hasher, d.bytes.data(), d.bytes.size());
+    return d;
+}
+
+/** ``BLAKE3(0x02 || u64 size || chunk root)``: leaf of the layer tree. */
+inline Digest32 merkle_layer(const Digest32& chunk_root, std::uint64_t size) {
+    std::uint8_t buf[41];
+    buf[0] = 0x02;
+    for (int i = 0; i < 8; ++i)
+        buf[1 + i] = static_cast<std::uint8_t>(size >> (8 * i));
+    std::copy(chunk_root.bytes.begin(), chunk_root.bytes.end(), buf + 9);
+    Digest32 d;
+    blake3_hasher hasher;
+    blake3_hasher_init(&hasher);
+    blake3_hasher_update(&hasher, buf, sizeof(buf));
+    blake3_hasher_finalize(&hasher, d.bytes.data(), d.bytes.size());
+    return d;
+}
+
+/**
+ * ``BLAKE3(0x03 || u64 count || tree root)``: checkpoint root. Binding the
+ * layer count fixes the tree shape, so a path cannot be replayed at another
+ * index of a smaller tree whose root folds to the same node.
+ */
+inline Digest32 merkle_root(const Digest32& tree_root, std::uint64_t count) {
+    std::uint8_t buf[41];
+    buf[0] = 0x03;
+    for (int i = 0; i < 8; ++i)
+        buf[1 + i] = static_cast<std::uint8_t>(count >> (8 * i));
+    std::copy(tree_root.bytes.begin(), tree_root.bytes.end(), buf + 9);
+    Digest32 d;
+    blake3_hasher hasher;
+    blake3_hasher_init(&hasher);
+    blake3_hasher_update(&hasher, buf, sizeof(buf));
+    blake3_hasher_finalize(&hasher, d.bytes.data(), d.bytes.size());
+    return d;
+}
+
+inline std::size_t merkle_chunk_count(std::size_t size, std::size_t chunk_size) {
+    return size == 0 ? 1 : (size + chunk_size - 1) / chunk_size;
+}
+
+} // namespace detail
+
+/**
+ * @brief Binary Merkle tree that keeps every level for incremental updates.
+ *
+ * A level of odd width promotes its last node unchanged to the next level, so
+ * trees of any width need no padding. ``set`` only records the leaf; the next
+ * ``root`` call recomputes the ancestors of modified leaves, costing
+ * ``O(k log n)`` node hashes for ``k`` changed leaves.
+ */
+class MerkleLevels {
+  public:
+    /** Rebuild the tree over ``leaves``. An empty tree has an all-zero root. */
+    void assign(std::vector<Digest32> leaves) {
+        levels_.clear();
+        dirty_.clear();
+        levels_.push_back(std::move(leaves));
+        while (levels_.back().size() > 1) {
+            const auto& below = levels_.back();
+            std::vector<Digest32> up((below.size() + 1) / 2);
+            for (std::size_t p = 0; p < up.size(); ++p)
+                up[p] = parent(below, p);
+            levels_.push_back(std::move(up));
+        }
+    }
+
+    void set(std::size_t i, const Digest32& leaf) {
+        if (i >= size())
+            throw std::runtime_error("merkle leaf out of range");
+        levels_[0][i] = leaf;
+        dirty_.push_back(i);
+    }
+
+    const Digest32& root() {
+        static const Digest32 empty{};
+        if (levels_.empty() || levels_[0].empty())
+            return empty;
+        if (!dirty_.empty()) {
+            std::sort(dirty_.begin(), dirty_.end());
+            dirty_.erase(std::unique(dirty_.begin(), dirty_.end()), dirty_.end());
+            for (std::size_t l = 1; l < levels_.size(); ++l) {
+                std::size_t kept = 0;
+                for (std::size_t i : dirty_) {
+                    std::size_t p = i / 2;
+                    if (kept && dirty_[kept - 1] == p)
+                        continue;
+                    levels_[l][p] = parent(levels_[l - 1], p);
+                    dirty_[kept++] = p;
+                }
+                dirty_.resize(kept);
+            }
+            dirty_.clear();
+        }
+        return levels_.back()[0];
+    }
+
+    const Digest32& leaf(std::size_t i) const { return levels_[0].at(i); }
+    std::size_t size() const { return levels_.empty() ? 0 : levels_[0].size(); }
+
+    /** Sibling hashes from leaf ``i`` up to the root; call after ``root``. */
+    std::vector<Digest32> path(std::size_t i) const {
+        if (i >= size())
+            throw std::runtime_error("merkle leaf out of range");
+        std::vector<Digest32> out;
+        for (std::size_t l = 0; l + 1 < levels_.size(); ++l, i /= 2) {
+            std::size_t sib = i ^ 1u;
+            if (sib < levels_[l].size())
+                out.push_back(levels_[l][sib]);
+        }
+        return out;
+    }
+
+    /**
+     * Fold ``leaf`` at ``index`` of a ``width``-leaf tree with ``path``.
+     * Returns false if the path length does not fit the tree shape.
+     */
+    static bool fold(Digest32 leaf, std::size_t index, std::size_t width,
+                     const std::vector<Digest32>& path, Digest32& root) {
+        if (index >= width)
+            return false;
+        std::size_t used = 0;
+        for (; width > 1; width = (width + 1) / 2, index /= 2) {
+            if ((index ^ 1u) >= width)
+                continue;
+            if (used == path.size())
+                return false;
+            const Digest32& sib = path[used++];
+            leaf = index & 1u ? detail::merkle_node(sib, leaf) : detail::merkle_node(leaf, sib);
+        }
+        root = leaf;
+        return used == path.size();
+    }
+
+  private:
+    static Digest32 parent(const std::vector<Digest32>& below, std::size_t p) {
+        return 2 * p + 1 < below.size() ? detail::merkle_node(below[2 * p], below[2 * p + 1])
+                                        : below[2 * p];
+    }
+
+    std::vector<std::vector<Digest32>> levels_{};
+    std::vector<std::size_t> dirty_{};
+};
+
+/** Proof that one tensor is part of a Merkle checkpoint root. */
+struct MerkleInclusionProof {
+    std::size_t index{0};
+    std::size_t layers{0};
+    /// Sibling hashes of the layer tree, leaf to root.
+    std::vector<Digest32> siblings{};
+};
+
+/**
+ * @brief Merkle mode of ``Blake3ProofSystem``.
+ *
+ * Every tensor is split into ``chunk_size`` byte chunks. Chunk hashes form a
+ * tree per tensor, whose root and the tensor size give that tensor's layer
+ * leaf; layer leaves form the checkpoint tree, whose root is hashed with the
+ * tensor count into the checkpoint root. Chunks are hashed on up to
+ * ``threads`` workers and ``layer_proof`` lets a verifier check one tensor
+ * against a root without the others. The root is a 64 digit hex string and
+ * the proof and loss fields follow ``Blake3ProofSystem``; roots depend on
+ * ``chunk_size``, so provers and verifiers must agree on it.
+ *
+ * This class rehashes every tensor on each call. Trainers that prove every
+ * step should keep a ``MerkleCheckpoint`` instead.
+ */
+class MerkleProofSystem : public IProofSystem {
+  public:
+    explicit MerkleProofSystem(std::size_t chunk_size = kMerkleChunkSize, unsigned threads = 0)
+        : chunk_size_{chunk_size}, threads_{threads} {
+        if (chunk_size_ == 0)
+            throw std::runtime_error("merkle chunk size must be positive");
+    }
+
+    using IProofSystem::generate_proof;
+    using IProofSystem::verify_proof;
+
+    StarkProof generate_proof(const TensorView* tensors, std::size_t count) const override {
+        MerkleLevels tree;
+        tree.assign(layer_leaves(tensors, count));
+        return make_proof(detail::merkle_root(tree.root(), count), tensors, count);
+    }
+
+    StarkProof generate_proof(const std::vector<std::vector<int8_t>>& tensors) const override {
+        auto views = tensor_views(tensors);
+        return generate_proof(views.data(), views.size());
+    }
+
+    bool verify_proof(const TensorView* tensors, std::size_t count,
+                      const StarkProof& proof) const override {
+        auto expected = generate_proof(tensors, count);
+        return expected.root == proof.root && expected.loss == proof.loss &&
+               expected.proof == proof.proof;
+    }
+
+    bool verify_proof(const std::vector<std::vector<int8_t>>& tensors,
+                      const StarkProof& proof) const override {
+        auto views = tensor_views(tensors);
+        return verify_proof(views.data(), views.size(), proof);
+    }
+
+    /** Inclusion proof for ``tensors[index]``. */
+    MerkleInclusionProof layer_proof(const TensorView* tensors, std::size_t count,
+                                     std::size_t index) const {
+        MerkleLevels tree;
+        tree.assign(layer_leaves(tensors, count));
+        tree.root();
+        return {index, count, tree.path(index)};
+    }
+
+    /** Check that ``layer`` is tensor ``proof.index`` under ``root``. */
+    bool verify_layer(const Digest32& root, TensorView layer,
+                      const MerkleInclusionProof& proof) const {
+        Digest32 folded;
+        return MerkleLevels::fold(layer_leaf(layer), proof.index, proof.layers, proof.siblings,
+                                  folded) &&
+               detail::merkle_root(folded, proof.layers) == root;
+    }
+
+    /** Layer leaf of ``t``; chunks are hashed on the calling thread. */
+    Digest32 layer_leaf(TensorView t) const {
+        const std::size_t n = detail::merkle_chunk_count(t.size, chunk_size_);
+        std::vector<Digest32> chunks(n);
+        for (std::size_t c = 0; c < n; ++c)
+            chunks[c] = hash_chunk(t, c);
+        MerkleLevels tree;
+        tree.assign(std::move(chunks));
+        return detail::merkle_layer(tree.root(), t.size);
+    }
+
+    std::size_t chunk_size() const { return chunk_size_; }
+    unsigned threads() const { return threads_; }
+
+  private:
+    friend class MerkleCheckpoint;
+
+    Digest32 hash_chunk(TensorView t, std::size_t c) const {
+        const std::size_t off = c * chunk_size_;
+        return detail::merkle_chunk(t.data + off, std::min(chunk_size_, t.size - off));
+    }
+
+    /**
+     * Hash every chunk of every tensor in parallel. Chunks of tensor ``i``
+     * occupy ``[first[i], first[i + 1])`` of the result.
+     */
+    std::vector<Digest32> chunk_hashes(const TensorView* tensors, std::size_t count,
+                                       std::vector<std::size_t>& first) const {
+        first.assign(count + 1, 0);
+        for (std::size_t i = 0; i < count; ++i)
+            first[i + 1] = first[i] + detail::merkle_chunk_count(tensors[i].size, chunk_size_);
+        std::vector<Digest32> chunks(first[count]);
+        std::vector<std::size_t> owner(chunks.size());
+        for (std::size_t i = 0; i < count; ++i)
+            std::fill(owner.begin() + first[i], owner.begin() + first[i + 1], i);
+        parallel_for(chunks.size(), threads_, [&](std::size_t k) {
+            chunks[k] = hash_chunk(tensors[owner[k]], k - first[owner[k]]);
+        });
+        return chunks;
+    }
+
+    std::vector<Digest32> layer_leaves(const TensorView* tensors, std::size_t count) const {
+        std::vector<std::size_t> first;
+        std::vector<Digest32> chunks = chunk_hashes(tensors, count, first);
+        std::vector<Digest32> leaves(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            MerkleLevels tree;
+            tree.assign(std::vector<Digest32>(chunks.begin() + first[i],
+                                              chunks.begin() + first[i + 1]));
+            leaves[i] = detail::merkle_layer(tree.root(), tensors[i].size);
+        }
+        return leaves;
+    }
+
+    static StarkProof make_proof(const Digest32& root, const TensorView* tensors,
+                                 std::size_t count) {
+        StarkProof p{};
+        p.root = root.hex();
+        p.proof = blake3_digest(p.root.data(), p.root.size());
+        p.loss = compute_loss(tensors, count);
+        return p;
+    }
+
+    std::size_t chunk_size_;
+    unsigned threads_;
+};
+
+/**
+ * @brief Merkle checkpoint root kept up to date across training steps.
+ *
+ * Holds views of the model tensors together with every chunk, layer and root
+ * hash. After the trainer modifies weights in place it calls ``touch`` for
+ * the affected tensor or byte range; ``root`` then rehashes only the touched
+ * chunks, in parallel, and the tree paths above them. The result always
+ * equals ``MerkleProofSystem::generate_proof`` over the same tensors.
+ * Modifications that are not reported through ``touch`` or ``set_tensor``
+ * are not seen. Not thread-safe.
+ */
+class MerkleCheckpoint {
+  public:
+    explicit MerkleCheckpoint(std::size_t chunk_size = kMerkleChunkSize, unsigned threads = 0)
+        : system_{chunk_size, threads} {}
+
+    /** Replace all tensors and rebuild every hash. */
+    void assign(const TensorView* tensors, std::size_t count) {
+        views_.assign(tensors, tensors + count);
+        layers_.assign(count, {});
+        dirty_.clear();
+        std::vector<std::size_t> first;
+        std::vector<Digest32> chunks = system_.chunk_hashes(tensors, count, first);
+        std::vector<Digest32> leaves(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            layers_[i].assign(std::vector<Digest32>(chunks.begin() + first[i],
+                                                    chunks.begin() + first[i + 1]));
+            leaves[i] = detail::merkle_layer(layers_[i].root(), views_[i].size);
+        }
+        tree_.assign(std::move(leaves));
+    }
+
+    void assign(const std::vector<std::vector<int8_t>>& tensors) {
+        auto views = tensor_views(tensors);
+        assign(views.data(), views.size());
+    }
+
+    /** Mark ``size`` bytes of tensor ``index`` starting at ``offset`` as modified. */
+    void touch(std::size_t index, std::size_t offset, std::size_t size) {
+        const TensorView& t = view(index);
+        if (offset > t.size || size > t.size - offset)
+            throw std::runtime_error("merkle touch out of range");
+        if (size == 0)
+            return;
+        for (std::size_t c = offset / chunk_size(); c <= (offset + size - 1) / chunk_size(); ++c)
+            dirty_.push_back({index, c});
+    }
+
+    /** Mark the whole of tensor ``index`` as modified. */
+    void touch(std::size_t index) { touch(index, 0, view(index).size); }
+
+    /**
+     * Point tensor ``index`` at new memory, e.g. after its vector was
+     * reallocated. The tensor is rehashed in full on the next ``root``.
+     */
+    void set_tensor(std::size_t index, TensorView t) {
+        view(index);
+        // Chunks touched before the move may lie past the end of ``t``.
+        dirty_.erase(std::remove_if(dirty_.begin(), dirty_.end(),
+                                    [index](const auto& d) { return d.first == index; }),
+                     dirty_.end());
+        views_[index] = t;
+        layers_[index].assign(
+            std::vector<Digest32>(detail::merkle_chunk_count(t.size, chunk_size())));
+        for (std::size_t c = 0; c < layers_[index].size(); ++c)
+            dirty_.push_back({index, c});
+    }
+
+    /**
+     * Current checkpoint root. Pending chunks are only dropped once every
+     * hash is stored, so a call that throws can simply be retried.
+     */
+    const Digest32& root() {
+        if (!dirty_.empty()) {
+            std::sort(dirty_.begin(), dirty_.end());
+            dirty_.erase(std::unique(dirty_.begin(), dirty_.end()), dirty_.end());
+            std::vector<Digest32> hashes(dirty_.size());
+            parallel_for(dirty_.size(), system_.threads(), [&](std::size_t k) {
+                hashes[k] = system_.hash_chunk(views_[dirty_[k].first], dirty_[k].second);
+            });
+            for (std::size_t k = 0; k < dirty_.size(); ++k) {
+                const std::size_t i = dirty_[k].first;
+                layers_[i].set(dirty_[k].second, hashes[k]);
+                if (k + 1 == dirty_.size() || dirty_[k + 1].first != i)
+                    tree_.set(i, detail::merkle_layer(layers_[i].root(), views_[i].size));
+            }
+            dirty_.clear();
+        }
+        root_ = detail::merkle_root(tree_.root(), views_.size());
+        return root_;
+    }
+
+    /** Proof for the current tensors, identical to ``MerkleProofSystem``'s. */
+    StarkProof proof() {
+        const Digest32& r = root();
+        return MerkleProofSystem::make_proof(r, views_.data(), views_.size());
+    }
+
+    /** Inclusion proof for tensor ``index`` against ``root()``. */
+    MerkleInclusionProof layer_proof(std::size_t index) {
+        view(index);
+        root();
+        return {index, views_.size(), tree_.path(index)};
+    }
+
+    const MerkleProofSystem& system() const { return system_; }
+    std::size_t chunk_size() const { return system_.chunk_size(); }
+    std::size_t size() const { return views_.size(); }
+
+  private:
+    const TensorView& view(std::size_t index) const {
+        if (index >= views_.size())
+            throw std::runtime_error("merkle tensor out of range");
+        return views_[index];
+    }
+
+    MerkleProofSystem system_;
+    std::vector<TensorView> views_{};
+    std::vector<MerkleLevels> layers_{};
+    MerkleLevels tree_{};
+    Digest32 root_{};
+    std::vector<std::pair<std::size_t, std::size_t>> dirty_{};
+};
+
+} // namespace neuropet
@@ -1,9 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "harmonics/websocket_io.hpp"
+#include "neuropet/mpmc_ring.hpp"
 
 namespace neuropet {
 
@@ -13,31 +25,154 @@ struct TrainingMetrics {
     float loss{0.0f};
 };
 
+/** Tuning knobs for ``MetricsStreamer``. */
+struct MetricsStreamerOptions {
+    /// Records buffered before the oldest ones are dropped.
+    std::size_t capacity{4096};
+    /// How often the sender thread flushes buffered records.
+    std::chrono::milliseconds interval{50};
+    /// Upper bound on records packed into a single frame.
+    std::size_t max_batch{1024};
+};
+
 /**
  * @brief Utility for streaming metrics over a WebSocket connection.
  *
- * Each ``TrainingMetrics`` record is packed into a two element float tensor and
- * sent using the Harmonics ``WebSocketConsumer``. The class is intentionally
- * minimal since the unit tests only require a lightweight metrics channel.
+ * ``push`` only appends the record to a lock-free ring, so training never
+ * waits on the network. A background thread wakes every ``interval`` and
+ * sends the buffered records as ``{n, 2}`` float tensors holding one
+ * ``[step, loss]`` row per record. When the dashboard falls behind and the
+ * ring fills up, the oldest records are discarded and counted in
+ * ``dropped()``.
  */
 class MetricsStreamer {
   public:
+    /// Receives each batched frame on the sender thread.
+    using Sink = std::function<void(const harmonics::HTensor&)>;
+
     MetricsStreamer(const std::string& host, unsigned short port,
-                    const std::string& path = "/metrics")
-        : socket_{host, port, path} {}
+                    const std::string& path = "/metrics", MetricsStreamerOptions opts = {})
+        : MetricsStreamer(socket_sink(host, port, path), opts) {}
+
+    /** Stream frames to ``sink`` instead of a WebSocket. */
+    explicit MetricsStreamer(Sink sink, MetricsStreamerOptions opts = {})
+        : opts_{opts}, sink_{std::move(sink)}, ring_{opts.capacity} {
+        if (opts_.max_batch == 0)
+            opts_.max_batch = 1;
+        worker_ = std::thread([this]() { run(); });
+    }
 
-    /** Send metrics to the configured WebSocket endpoint. */
+    /** Sends every buffered record before returning. */
+    ~MetricsStreamer() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (worker_.joinable())
+            worker_.join();
+    }
+
+    MetricsStreamer(const MetricsStreamer&) = delete;
+    MetricsStreamer& operator=(const MetricsStreamer&) = delete;
+
+    /** Queue metrics for the next frame, dropping the oldest record if full. */
     void push(const TrainingMetrics& m) {
-        harmonics::HTensor t{harmonics::HTensor::DType::Float32, {2}};
-        t.data().resize(sizeof(float) * 2);
-        float* d = reinterpret_cast<float*>(t.data().data());
-        d[0] = static_cast<float>(m.step);
-        d[1] = m.loss;
-        socket_.push(t);
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+        TrainingMetrics old;
+        while (!ring_.try_push(m)) {
+            if (ring_.try_pop(old))
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 
+    /**
+     * Block until every record pushed before the call was sent or dropped.
+     * Rethrows the first error raised by the sink.
+     */
+    void flush() {
+        std::uint64_t target = pushed_.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lk(m_);
+        flush_requested_ = true;
+        cv_.notify_all();
+        while (sent() + dropped() < target)
+            cv_.wait_for(lk, opts_.interval);
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+    /** Records delivered to the sink. */
+    std::uint64_t sent() const { return sent_.load(std::memory_order_relaxed); }
+    /** Records discarded by backpressure or a failing sink. */
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    /** Frames delivered to the sink. */
+    std::uint64_t frames() const { return frames_.load(std::memory_order_relaxed); }
+
   private:
-    harmonics::WebSocketConsumer socket_;
+    static Sink socket_sink(const std::string& host, unsigned short port,
+                            const std::string& path) {
+        auto socket = std::make_shared<harmonics::WebSocketConsumer>(host, port, path);
+        return [socket](const harmonics::HTensor& t) { socket->push(t); };
+    }
+
+    void run() {
+        std::vector<TrainingMetrics> batch;
+        batch.reserve(std::min(opts_.max_batch, ring_.capacity()));
+        std::unique_lock<std::mutex> lk(m_);
+        for (;;) {
+            cv_.wait_for(lk, opts_.interval, [this]() { return stop_ || flush_requested_; });
+            flush_requested_ = false;
+            bool stopping = stop_;
+            lk.unlock();
+            drain(batch);
+            lk.lock();
+            cv_.notify_all();
+            if (stopping)
+                return;
+        }
+    }
+
+    void drain(std::vector<TrainingMetrics>& batch) {
+        for (;;) {
+            batch.clear();
+            TrainingMetrics m;
+            while (batch.size() < opts_.max_batch && ring_.try_pop(m))
+                batch.push_back(m);
+            if (batch.empty())
+                return;
+            harmonics::HTensor t{harmonics::HTensor::DType::Float32, {batch.size(), 2}};
+            t.data().resize(sizeof(float) * 2 * batch.size());
+            float* d = reinterpret_cast<float*>(t.data().data());
+            for (std::size_t i = 0; i < batch.size(); ++i) {
+                d[2 * i] = static_cast<float>(batch[i].step);
+                d[2 * i + 1] = batch[i].loss;
+            }
+            try {
+                sink_(t);
+                sent_.fetch_add(batch.size(), std::memory_order_relaxed);
+                frames_.fetch_add(1, std::memory_order_relaxed);
+            } catch (...) {
+                dropped_.fetch_add(batch.size(), std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lk(m_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+        }
+    }
+
+    MetricsStreamerOptions opts_{};
+    Sink sink_{};
+    MpmcRing<TrainingMetrics> ring_;
+    std::atomic<std::uint64_t> pushed_{0};
+    std::atomic<std::uint64_t> sent_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> frames_{0};
+    std::mutex m_{};
+    std::condition_variable cv_{};
+    bool stop_{false};
+    bool flush_requested_{false};
+    std::exception_ptr error_{};
+    std::thread worker_{};
 };
 
 } // namespace neuropet
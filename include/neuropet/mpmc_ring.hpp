@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace neuropet {
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer ring.
+ *
+ * Every cell carries a sequence number telling producers and consumers
+ * whether it is free or filled for the current lap, so ``try_push`` and
+ * ``try_pop`` only need a single compare-and-swap on the shared cursor.
+ * Capacity is rounded up to a power of two.
+ */
+template <class T> class MpmcRing {
+    static_assert(std::is_trivially_copyable_v<T>, "MpmcRing stores trivially copyable values");
+
+  public:
+    explicit MpmcRing(std::size_t capacity) {
+        std::size_t n = 2;
+        while (n < capacity)
+            n <<= 1;
+        mask_ = n - 1;
+        cells_ = std::make_unique<Cell[]>(n);
+        for (std::size_t i = 0; i < n; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    /** Append ``v``; returns false if the ring is full. */
+    bool try_push(const T& v) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & mask_];
+            std::size_t seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = v;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Remove the oldest value into ``out``; returns false if empty. */
+    bool try_pop(T& out) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & mask_];
+            std::size_t seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = c.value;
+                    c.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Number of cells in the ring. */
+    std::size_t capacity() const { return mask_ + 1; }
+
+    /** Approximate number of queued values; exact when no thread is active. */
+    std::size_t size() const {
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        std::size_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+  private:
+    struct Cell {
+        std::atomic<std::size_t> seq{0};
+        T value{};
+    };
+
+    std::size_t mask_{0};
+    std::unique_ptr<Cell[]> cells_{};
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+} // namespace neuropet
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "neuropet/battle.hpp"
+#include "neuropet/training.hpp"
+
+namespace neuropet {
+
+/** Actions decoded from a creature's appendage outputs, in output order. */
+enum class NeuralAction : std::uint8_t { MoveNorth, MoveSouth, MoveEast, MoveWest, Attack, Block };
+
+/**
+ * Width of the sensor vector fed to a creature each turn:
+ * ``{tile, dx, dy, adjacent, hp, stamina}``. ``tile`` is the
+ * ``BattleEngine::Tile`` under the creature, ``dx``/``dy`` the offset to the
+ * opponent (east and south are positive), ``adjacent`` is 1 when the
+ * opponent is within attack range and ``hp``/``stamina`` are clamped to 127.
+ */
+constexpr std::size_t kNeuralSensorInputs = 6;
+
+/** One pairing for ``NeuralBattleEngine::fight_batch``. */
+struct NeuralMatch {
+    const CreatureStats* a{nullptr};
+    const CreatureModel* model_a{nullptr};
+    const CreatureStats* b{nullptr};
+    const CreatureModel* model_b{nullptr};
+    std::uint32_t seed{0};
+};
+
+/** Output of ``NeuralBattleEngine::fight_batch``. */
+struct NeuralBatchResult {
+    std::vector<std::uint32_t> winners{};
+    /// Turns each battle lasted.
+    std::vector<std::uint32_t> turns{};
+    /// Batched ``run_inference_batch`` calls issued for the whole batch.
+    std::uint64_t inference_calls{0};
+};
+
+/**
+ * @brief Battle loop where every action comes from the creatures' INT8 networks.
+ *
+ * Creatures start in opposite corners as in ``BattleEngine::fight`` and the
+ * first mover follows the same seed parity rule. Each turn the mover of every
+ * live battle senses the board, its network picks the ``NeuralAction`` with
+ * the largest appendage output (ties go to the lower index) and the action
+ * is applied with the ``fight`` rules: moves into walls, off the board or
+ * onto the opponent are wasted, hazards cost one hp, attacks need range and
+ * stamina and are absorbed by the defender's accumulated block. A battle ends
+ * when a creature falls, both are out of stamina or ``max_turns`` is reached;
+ * the winner is decided by ``hpA >= hpB`` as in ``fight``.
+ *
+ * All battles of a batch advance in lockstep. Sensor rows of every battle
+ * whose mover shares a model are stacked and evaluated with one
+ * ``run_inference_batch`` call per turn, so a population sharing a network
+ * costs one matrix multiply per layer per turn instead of one per battle.
+ * Results do not depend on how battles are batched.
+ */
+class NeuralBattleEngine {
+  public:
+    explicit NeuralBattleEngine(const BattleEngine& board = BattleEngine{},
+                                std::uint32_t max_turns = 256)
+        : board_{board}, max_turns_{max_turns} {}
+
+    std::uint32_t fight(const CreatureStats& a, const CreatureModel& model_a,
+                        const CreatureStats& b, const CreatureModel& model_b,
+                        std::uint32_t seed = 0) const {
+        return fight_batch({{&a, &model_a, &b, &model_b, seed}}).winners[0];
+    }
+
+    /**
+     * Run every pairing in ``matches`` concurrently. Throws
+     * ``std::runtime_error`` if a pairing is missing a creature or model or a
+     * model does not take ``kNeuralSensorInputs`` inputs.
+     */
+    NeuralBatchResult fight_batch(const std::vector<NeuralMatch>& matches) const {
+        const std::size_t n = matches.size();
+        NeuralBatchResult res;
+        res.winners.resize(n);
+        res.turns.assign(n, 0);
+
+        std::vector<State> st(n);
+        std::vector<std::size_t> live;
+        live.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const NeuralMatch& m = matches[i];
+            if (!m.a || !m.b || !m.model_a || !m.model_b)
+                throw std::runtime_error("incomplete neural match");
+            State& s = st[i];
+            s.side[0] = {{0, 0}, m.a->total_power(), m.a->total_defense(), m.a->total_stamina(), 0};
+            s.side[1] = {{7, 7}, m.b->total_power(), m.b->total_defense(), m.b->total_stamina(), 0};
+            for (auto& f : s.side)
+                if (board_.tile_at(f.pos.x, f.pos.y) == BattleEngine::Tile::HAZARD)
+                    --f.hp;
+            unsigned seed = m.seed ? m.seed : (m.a->id ^ m.b->id);
+            s.mover = (seed & 1u) == 0 ? 0 : 1;
+            if (running(s))
+                live.push_back(i);
+        }
+
+        struct Group {
+            const CreatureModel* model;
+            std::vector<std::size_t> battles;
+            std::vector<int8_t> rows;
+        };
+        std::vector<Group> groups;
+        std::unordered_map<const CreatureModel*, std::size_t> group_of;
+        for (std::uint32_t turn = 0; turn < max_turns_ && !live.empty(); ++turn) {
+            for (auto& g : groups) {
+                g.battles.clear();
+                g.rows.clear();
+            }
+            for (std::size_t i : live) {
+                const CreatureModel* model =
+                    st[i].mover == 0 ? matches[i].model_a : matches[i].model_b;
+                auto [it, inserted] = group_of.try_emplace(model, groups.size());
+                if (inserted)
+                    groups.push_back({model, {}, {}});
+                Group& g = groups[it->second];
+                g.battles.push_back(i);
+                sense(st[i], g.rows);
+            }
+            for (auto& g : groups) {
+                if (g.battles.empty())
+                    continue;
+                const std::size_t rows = g.battles.size();
+                std::vector<int8_t> out = run_inference_batch(*g.model, g.rows, rows);
+                ++res.inference_calls;
+                const std::size_t width = out.size() / rows;
+                if (width == 0)
+                    throw std::runtime_error("creature model has no outputs");
+                for (std::size_t r = 0; r < rows; ++r)
+                    apply(st[g.battles[r]], decode(out.data() + r * width, width));
+            }
+            std::size_t kept = 0;
+            for (std::size_t i : live) {
+                ++res.turns[i];
+                if (running(st[i]))
+                    live[kept++] = i;
+            }
+            live.resize(kept);
+        }
+
+        for (std::size_t i = 0; i < n; ++i)
+            res.winners[i] = st[i].side[0].hp >= st[i].side[1].hp ? matches[i].a->id
+                                                                  : matches[i].b->id;
+        return res;
+    }
+
+    const BattleEngine& board() const { return board_; }
+    std::uint32_t max_turns() const { return max_turns_; }
+
+    /** Pick the action with the largest of the first six outputs. */
+    static NeuralAction decode(const int8_t* out, std::size_t width) {
+        std::size_t best = 0;
+        const std::size_t n = std::min<std::size_t>(width, 6);
+        for (std::size_t i = 1; i < n; ++i)
+            if (out[i] > out[best])
+                best = i;
+        return static_cast<NeuralAction>(best);
+    }
+
+  private:
+    struct Fighter {
+        BattleEngine::Position pos;
+        int power;
+        int hp;
+        int stamina;
+        int block;
+    };
+
+    struct State {
+        Fighter side[2];
+        int mover{0};
+    };
+
+    static bool running(const State& s) {
+        return s.side[0].hp > 0 && s.side[1].hp > 0 &&
+               (s.side[0].stamina > 0 || s.side[1].stamina > 0);
+    }
+
+    static int8_t saturate(int v) { return static_cast<int8_t>(std::clamp(v, -128, 127)); }
+
+    void sense(const State& s, std::vector<int8_t>& rows) const {
+        const Fighter& self = s.side[s.mover];
+        const Fighter& opp = s.side[1 - s.mover];
+        const int dx = opp.pos.x - self.pos.x;
+        const int dy = opp.pos.y - self.pos.y;
+        rows.push_back(static_cast<int8_t>(board_.tile_at(self.pos.x, self.pos.y)));
+        rows.push_back(static_cast<int8_t>(dx));
+        rows.push_back(static_cast<int8_t>(dy));
+        rows.push_back(std::abs(dx) + std::abs(dy) <= 1 ? 1 : 0);
+        rows.push_back(saturate(self.hp));
+        rows.push_back(saturate(self.stamina));
+    }
+
+    void apply(State& s, NeuralAction action) const {
+        Fighter& self = s.side[s.mover];
+        Fighter& opp = s.side[1 - s.mover];
+        int nx = self.pos.x;
+        int ny = self.pos.y;
+        switch (action) {
+        case NeuralAction::MoveNorth:
+            --ny;
+            break;
+        case NeuralAction::MoveSouth:
+            ++ny;
+            break;
+        case NeuralAction::MoveEast:
+            ++nx;
+            break;
+        case NeuralAction::MoveWest:
+            --nx;
+            break;
+        case NeuralAction::Attack:
+            if (self.stamina > 0 &&
+                std::abs(opp.pos.x - self.pos.x) + std::abs(opp.pos.y - self.pos.y) <= 1) {
+                int dmg = self.power;
+                if (opp.block > 0) {
+                    dmg = std::max(0, dmg - opp.block);
+                    opp.block = 0;
+                }
+                opp.hp -= dmg;
+                --self.stamina;
+            }
+            break;
+        case NeuralAction::Block:
+            ++self.block;
+            break;
+        }
+        if ((nx != self.pos.x || ny != self.pos.y) &&
+            board_.tile_at(nx, ny) != BattleEngine::Tile::WALL &&
+            !(nx == opp.pos.x && ny == opp.pos.y)) {
+            self.pos = {nx, ny};
+            if (board_.tile_at(nx, ny) == BattleEngine::Tile::HAZARD)
+                --self.hp;
+        }
+        s.mover = 1 - s.mover;
+    }
+
+    BattleEngine board_{};
+    std::uint32_t max_turns_{256};
+};
+
+} // namespace neuropet
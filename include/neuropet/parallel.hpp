@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace neuropet {
+
+/** Resolve a requested worker count; zero selects all hardware threads. */
+inline unsigned resolve_thread_count(unsigned requested) {
+    if (requested)
+        return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+/**
+ * @brief Invoke ``fn(i)`` for every ``i`` in ``[0, count)`` using up to
+ * ``threads`` workers.
+ *
+ * Indices are handed out dynamically so uneven work items balance across
+ * workers. Callers must write results to index-specific slots; the order in
+ * which indices run is unspecified. The first exception thrown by ``fn`` is
+ * rethrown after all workers have joined.
+ */
+template <class Fn> inline void parallel_for(std::size_t count, unsigned threads, Fn&& fn) {
+    unsigned workers = static_cast<unsigned>(
+        std::min<std::size_t>(resolve_thread_count(threads), count));
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+        for (;;) {
+            std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count)
+                return;
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+                next = count;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; ++w)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+/**
+ * @brief Fixed set of worker threads reused across ``parallel_for`` calls.
+ *
+ * ``parallel_for`` above starts and joins its threads on every call, which
+ * dominates when a loop of short parallel sections runs many times. The pool
+ * keeps ``size() - 1`` threads parked on a condition variable between calls;
+ * the calling thread always takes part. Index handout and exception
+ * propagation follow the free ``parallel_for``. Calls must not overlap or
+ * nest.
+ */
+class WorkerPool {
+  public:
+    /** Start ``resolve_thread_count(threads) - 1`` helper threads. */
+    explicit WorkerPool(unsigned threads = 0) {
+        unsigned n = resolve_thread_count(threads);
+        threads_.reserve(n - 1);
+        for (unsigned w = 1; w < n; ++w)
+            threads_.emplace_back([this]() { run(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& t : threads_)
+            t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /** Threads taking part in a call, including the caller. */
+    unsigned size() const { return static_cast<unsigned>(threads_.size()) + 1; }
+
+    /** Invoke ``fn(i)`` for every ``i`` in ``[0, count)`` on the pool. */
+    template <class Fn> void parallel_for(std::size_t count, Fn&& fn) {
+        if (threads_.empty() || count <= 1) {
+            for (std::size_t i = 0; i < count; ++i)
+                fn(i);
+            return;
+        }
+        using F = std::remove_reference_t<Fn>;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            call_ = [](void* ctx, std::size_t i) { (*static_cast<F*>(ctx))(i); };
+            ctx_ = const_cast<void*>(static_cast<const void*>(&fn));
+            count_ = count;
+            next_.store(0, std::memory_order_relaxed);
+            busy_ = threads_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+        drain();
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            done_cv_.wait(lk, [this]() { return busy_ == 0; });
+            std::swap(error, error_);
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+  private:
+    void drain() {
+        for (;;) {
+            std::size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count_)
+                return;
+            try {
+                call_(ctx_, i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(m_);
+                if (!error_)
+                    error_ = std::current_exception();
+                next_ = count_;
+            }
+        }
+    }
+
+    void run() {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lk(m_);
+        for (;;) {
+            start_cv_.wait(lk, [&]() { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+            lk.unlock();
+            drain();
+            lk.lock();
+            if (--busy_ == 0)
+                done_cv_.notify_one();
+        }
+    }
+
+    std::mutex m_{};
+    std::condition_variable start_cv_{};
+    std::condition_variable done_cv_{};
+    bool stop_{false};
+    std::uint64_t generation_{0};
+    std::size_t busy_{0};
+    std::exception_ptr error_{};
+    void (*call_)(void*, std::size_t){nullptr};
+    void* ctx_{nullptr};
+    std::size_t count_{0};
+    std::atomic<std::size_t> next_{0};
+    std::vector<std::thread> threads_{};
+};
+
+} // namespace neuropet
@@ -5,6 +5,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace neuropet {
@@ -27,28 +28,62 @@ class PoUWChain {
         std::string miner{};
         float loss{0.0f};
         std::uint32_t energy_spent{0};
+        Digest32 root{};
     };
 
+    // Checkpoints are keyed by ``Digest32``. The string overloads are the
+    // JSON-RPC boundary: roots given as 64 hex digits decode to their bytes
+    // and other labels are hashed (see ``Digest32::from_root``).
+
+    void submit_checkpoint(std::uint32_t creature_id, std::uint32_t epoch_id,
+                           const Digest32& root, const std::string& miner, float loss = 0.0f,
+                           std::uint32_t energy_spent = 0) {
+        pending_[root] = {creature_id, epoch_id, miner, loss, energy_spent};
+    }
+
     void submit_checkpoint(std::uint32_t creature_id, std::uint32_t epoch_id,
                            const std::string& root_hash, const std::string& miner,
                            float loss = 0.0f, std::uint32_t energy_spent = 0) {
-        pending_[root_hash] = {creature_id, epoch_id, miner, loss, energy_spent};
+        submit_checkpoint(creature_id, epoch_id, Digest32::from_root(root_hash), miner, loss,
+                          energy_spent);
     }
 
     /// Mark a checkpoint as proven by a valid STARK proof.
-    void submit_proof(const std::string& root_hash) { proven_.insert(root_hash); }
+    void submit_proof(const Digest32& root) { proven_.insert(root); }
+    void submit_proof(const std::string& root_hash) { submit_proof(Digest32::from_root(root_hash)); }
 
+    void attest(const Digest32& root) { validator_.attest(root); }
     void attest(const std::string& root_hash) { validator_.attest(root_hash); }
 
+    bool finalize_checkpoint(const Digest32& root) { return finalize(root, nullptr); }
+
     bool finalize_checkpoint(const std::string& root_hash) {
+        return finalize(Digest32::from_root(root_hash), &root_hash);
+    }
+
+    const std::vector<Block>& chain() const { return chain_; }
+
+    std::uint64_t energy_balance(const std::string& miner) const {
+        auto it = energy_balance_.find(miner);
+        return it == energy_balance_.end() ? 0 : it->second;
+    }
+
+    std::uint64_t core_balance(const std::string& miner) const {
+        auto it = core_balance_.find(miner);
+        return it == core_balance_.end() ? 0 : it->second;
+    }
+
+  private:
+    /** Finalize ``root``; ``label`` is the caller's spelling for ``Block::root_hash``. */
+    bool finalize(const Digest32& root, const std::string* label) {
         // A checkpoint is only finalized when either a sufficient number of
         // attestations were collected or a valid proof was submitted.
-        if (!validator_.has_quorum(root_hash) && !proven_.count(root_hash))
+        if (!validator_.has_quorum(root) && !proven_.count(root))
             return false;
 
         // Locate the pending entry; skip if unknown or already finalized.
-        auto it = pending_.find(root_hash);
-        if (it == pending_.end() || finalized_.count(root_hash))
+        auto it = pending_.find(root);
+        if (it == pending_.end() || finalized_.count(root))
             return false;
 
         // Enforce that epochs are finalized in sequence for each creature.
@@ -69,35 +104,23 @@ class PoUWChain {
         blk.index = static_cast<std::uint32_t>(chain_.size() + 1);
         blk.creature_id = it->second.creature_id;
         blk.epoch_id = it->second.epoch_id;
-        blk.root_hash = root_hash;
-        blk.miner = it->second.miner;
+        blk.root = root;
+        blk.root_hash = label ? *label : root.hex();
+        blk.miner = std::move(it->second.miner);
         blk.loss = it->second.loss;
         blk.energy_spent = it->second.energy_spent;
-        chain_.push_back(blk); // append to the canonical chain
         energy_balance_[blk.miner] += it->second.energy_spent;
         core_balance_[blk.miner] +=
             static_cast<std::uint64_t>(it->second.energy_spent) * CORE_PER_ENERGY;
-        finalized_.insert(root_hash);
-        proven_.erase(root_hash);
-        next_epoch_[blk.creature_id] = blk.epoch_id + 1;
-        last_loss_[blk.creature_id] = blk.loss;
+        chain_.push_back(std::move(blk)); // append to the canonical chain
+        finalized_.insert(root);
+        proven_.erase(root);
+        next_epoch_[chain_.back().creature_id] = chain_.back().epoch_id + 1;
+        last_loss_[chain_.back().creature_id] = chain_.back().loss;
         pending_.erase(it);
         return true;
     }
 
-    const std::vector<Block>& chain() const { return chain_; }
-
-    std::uint64_t energy_balance(const std::string& miner) const {
-        auto it = energy_balance_.find(miner);
-        return it == energy_balance_.end() ? 0 : it->second;
-    }
-
-    std::uint64_t core_balance(const std::string& miner) const {
-        auto it = core_balance_.find(miner);
-        return it == core_balance_.end() ? 0 : it->second;
-    }
-
-  private:
     struct Pending {
         std::uint32_t creature_id;
         std::uint32_t epoch_id;
@@ -107,9 +130,9 @@ class PoUWChain {
     };
 
     std::vector<Block> chain_{};
-    std::unordered_map<std::string, Pending> pending_{};
-    std::unordered_set<std::string> finalized_{};
-    std::unordered_set<std::string> proven_{};
+    std::unordered_map<Digest32, Pending, Digest32Hash> pending_{};
+    std::unordered_set<Digest32, Digest32Hash> finalized_{};
+    std::unordered_set<Digest32, Digest32Hash> proven_{};
     std::unordered_map<std::string, std::uint64_t> energy_balance_{};
     std::unordered_map<std::string, std::uint64_t> core_balance_{};
     std::unordered_map<std::uint32_t, std::uint32_t> next_epoch_{};
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <string>
@@ -21,28 +22,36 @@
 
 namespace neuropet {
 
-/** In-memory collection of STARK proofs identified by root hash. */
+/** In-memory collection of STARK proofs identified by root digest. */
 class ProofAggregator {
   public:
-    /// Store or update a proof. Existing entries are overwritten.
-    void submit(const StarkProof& p) {
+    /// Store or update a proof. Returns false if an identical proof was already stored.
+    bool submit(const StarkProof& p) { return submit(p.root_digest(), p.proof, p.loss); }
+
+    bool submit(const Digest32& root, const std::string& proof, float loss) {
         std::lock_guard<std::mutex> lock(mutex_);
-        proofs_[p.root] = {p.proof, p.loss};
+        auto [it, inserted] = proofs_.try_emplace(root, proof, loss);
+        if (inserted)
+            return true;
+        if (it->second.first == proof && it->second.second == loss)
+            return false;
+        it->second = {proof, loss};
+        return true;
     }
 
-    /// Return all known proofs.
+    /// Return all known proofs with hex roots.
     std::vector<StarkProof> all() const {
         std::lock_guard<std::mutex> lock(mutex_);
         std::vector<StarkProof> out;
         out.reserve(proofs_.size());
         for (const auto& kv : proofs_)
-            out.push_back({kv.first, kv.second.first, kv.second.second});
+            out.push_back({kv.first.hex(), kv.second.first, kv.second.second});
         return out;
     }
 
   private:
     mutable std::mutex mutex_{};
-    std::unordered_map<std::string, std::pair<std::string, float>> proofs_{};
+    std::unordered_map<Digest32, std::pair<std::string, float>, Digest32Hash> proofs_{};
 };
 
 #ifdef __unix__
@@ -58,7 +67,14 @@ struct AggregatorNetStats {
 /// Simple TCP server that distributes proofs to connected peers.
 class ProofAggregatorServer {
   public:
-    explicit ProofAggregatorServer(unsigned short port = 0) : port_hint_{port} {}
+    /**
+     * ``max_tracked_roots`` bounds how many roots remember which peers sent
+     * them; the oldest root is forgotten first, and a peer resending it is
+     * reported again.
+     */
+    explicit ProofAggregatorServer(unsigned short port = 0,
+                                   std::size_t max_tracked_roots = 4096)
+        : port_hint_{port}, max_tracked_{max_tracked_roots ? max_tracked_roots : 1} {}
     ~ProofAggregatorServer() { stop(); }
 
     unsigned short port() const { return port_; }
@@ -66,7 +82,17 @@ class ProofAggregatorServer {
     /// Inspect current network statistics.
     const AggregatorNetStats& stats() const { return stats_; }
 
-    /// Set a callback invoked whenever a proof is received.
+    /// Roots whose senders are currently remembered.
+    std::size_t tracked_roots() const {
+        std::lock_guard<std::mutex> lock(senders_mutex_);
+        return senders_.size();
+    }
+
+    /**
+     * Set a callback invoked once per proof root for each directly connected
+     * peer that submits it, and once for local submissions. Proofs relayed on
+     * behalf of other nodes are stored but not reported. Calls are serialized.
+     */
     void set_callback(std::function<void(const StarkProof&)> cb) { on_proof_ = std::move(cb); }
 
     /// Connect to another aggregator peer.
@@ -92,7 +118,7 @@ class ProofAggregatorServer {
         }
         std::thread(&ProofAggregatorServer::handle_client, this, fd).detach();
         for (const auto& p : agg_.all())
-            send_proof(fd, p, &stats_);
+            send_proof(fd, p, false, &stats_);
         return true;
     }
 
@@ -146,10 +172,10 @@ class ProofAggregatorServer {
 
     /// Submit a proof from the local process.
     void submit(const StarkProof& p) {
-        agg_.submit(p);
-        broadcast(p);
-        if (on_proof_)
-            on_proof_(p);
+        const Digest32 root = p.root_digest();
+        agg_.submit(root, p.proof, p.loss);
+        broadcast(p, true);
+        report(root, p, 0);
     }
 
   private:
@@ -182,6 +208,16 @@ class ProofAggregatorServer {
         return true;
     }
 
+    static bool send_digest(int fd, const Digest32& d) {
+        return ::send(fd, d.bytes.data(), d.bytes.size(), 0) ==
+               static_cast<ssize_t>(d.bytes.size());
+    }
+
+    static bool recv_digest(int fd, Digest32& d) {
+        return ::recv(fd, d.bytes.data(), d.bytes.size(), MSG_WAITALL) ==
+               static_cast<ssize_t>(d.bytes.size());
+    }
+
     static bool send_float(int fd, float f) {
         std::uint32_t bits;
         static_assert(sizeof(float) == sizeof(bits), "float size");
@@ -204,11 +240,17 @@ class ProofAggregatorServer {
         ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
     }
 
-    static bool send_proof(int fd, const StarkProof& p, AggregatorNetStats* s = nullptr) {
-        if (!send_string(fd, p.root) || !send_string(fd, p.proof) || !send_float(fd, p.loss))
+    // Wire format per proof: origin flag byte (1 when the sender submitted the
+    // proof itself, 0 when relaying), 32 raw root bytes, length-prefixed
+    // proof, loss.
+    static bool send_proof(int fd, const StarkProof& p, bool origin,
+                           AggregatorNetStats* s = nullptr) {
+        const std::uint8_t flag = origin ? 1 : 0;
+        if (::send(fd, &flag, 1, 0) != 1 || !send_digest(fd, p.root_digest()) ||
+            !send_string(fd, p.proof) || !send_float(fd, p.loss))
             return false;
         if (s) {
-            s->bytes_sent += 4 + p.root.size();
+            s->bytes_sent += 1 + 32;
             s->bytes_sent += 4 + p.proof.size();
             s->bytes_sent += 4;
             ++s->proofs_sent;
@@ -216,11 +258,16 @@ class ProofAggregatorServer {
         return true;
     }
 
-    static bool recv_proof(int fd, StarkProof& p, AggregatorNetStats* s = nullptr) {
-        if (!recv_string(fd, p.root) || !recv_string(fd, p.proof) || !recv_float(fd, p.loss))
+    static bool recv_proof(int fd, Digest32& root, StarkProof& p, bool& origin,
+                           AggregatorNetStats* s = nullptr) {
+        std::uint8_t flag = 0;
+        if (::recv(fd, &flag, 1, MSG_WAITALL) != 1 || !recv_digest(fd, root) ||
+            !recv_string(fd, p.proof) || !recv_float(fd, p.loss))
             return false;
+        p.root = root.hex();
+        origin = flag != 0;
         if (s) {
-            s->bytes_received += 4 + p.root.size();
+            s->bytes_received += 1 + 32;
             s->bytes_received += 4 + p.proof.size();
             s->bytes_received += 4;
             ++s->proofs_received;
@@ -247,14 +294,19 @@ class ProofAggregatorServer {
     }
 
     void handle_client(int fd) {
+        const std::uint64_t peer = ++next_peer_;
         StarkProof p{};
+        Digest32 root{};
+        bool origin = false;
         while (running_) {
-            if (!recv_proof(fd, p, &stats_))
+            if (!recv_proof(fd, root, p, origin, &stats_))
                 break;
-            agg_.submit(p);
-            broadcast(p);
-            if (on_proof_)
-                on_proof_(p);
+            // Known proofs were relayed before; relaying them again would
+            // have peers echo each proof back and forth indefinitely.
+            if (agg_.submit(root, p.proof, p.loss))
+                broadcast(p, false);
+            if (origin)
+                report(root, p, peer);
         }
         {
             std::lock_guard<std::mutex> lock(clients_mutex_);
@@ -263,10 +315,29 @@ class ProofAggregatorServer {
         ::close(fd);
     }
 
-    void broadcast(const StarkProof& p) {
+    /** Invoke ``on_proof_`` unless ``peer`` already submitted ``root``. */
+    void report(const Digest32& root, const StarkProof& p, std::uint64_t peer) {
+        std::lock_guard<std::mutex> lock(senders_mutex_);
+        auto [it, inserted] = senders_.try_emplace(root);
+        if (inserted) {
+            order_.push_back(root);
+            if (order_.size() > max_tracked_) {
+                senders_.erase(order_.front());
+                order_.pop_front();
+            }
+        }
+        auto& senders = it->second;
+        if (std::find(senders.begin(), senders.end(), peer) != senders.end())
+            return;
+        senders.push_back(peer);
+        if (on_proof_)
+            on_proof_(p);
+    }
+
+    void broadcast(const StarkProof& p, bool origin) {
         std::lock_guard<std::mutex> lock(clients_mutex_);
         for (auto it = clients_.begin(); it != clients_.end();) {
-            if (!send_proof(*it, p, &stats_)) {
+            if (!send_proof(*it, p, origin, &stats_)) {
                 ::close(*it);
                 it = clients_.erase(it);
                 continue;
@@ -287,6 +358,13 @@ class ProofAggregatorServer {
     std::mutex clients_mutex_{};
     std::atomic<bool> running_{false};
     std::function<void(const StarkProof&)> on_proof_{};
+    /// Peers that submitted each root; 0 stands for local submissions.
+    std::unordered_map<Digest32, std::vector<std::uint64_t>, Digest32Hash> senders_{};
+    /// Roots of ``senders_`` in insertion order, for eviction.
+    std::deque<Digest32> order_{};
+    std::size_t max_tracked_{4096};
+    mutable std::mutex senders_mutex_{};
+    std::atomic<std::uint64_t> next_peer_{0};
     AggregatorNetStats stats_{};
 };
 #endif // __unix__
@@ -9,6 +9,8 @@
 #include <string>
 #include <vector>
 
+#include "neuropet/digest32.hpp"
+
 namespace neuropet {
 
 inline std::string to_hex(const unsigned char* data, std::size_t len) {
@@ -47,6 +49,23 @@ inline std::string keccak256_digest(const void* data, std::size_t size) {
     return to_hex(out, outlen);
 }
 
+/** Non-owning view of one INT8 tensor passed to an ``IProofSystem``. */
+struct TensorView {
+    const int8_t* data{nullptr};
+    std::size_t size{0};
+
+    int8_t operator[](std::size_t i) const { return data[i]; }
+};
+
+/** Views over ``tensors`` without copying their contents. */
+inline std::vector<TensorView> tensor_views(const std::vector<std::vector<int8_t>>& tensors) {
+    std::vector<TensorView> views;
+    views.reserve(tensors.size());
+    for (const auto& t : tensors)
+        views.push_back({t.data(), t.size()});
+    return views;
+}
+
 /**
  * @brief Compute a simple loss metric from a collection of tensors.
  *
@@ -54,17 +73,17 @@ inline std::string keccak256_digest(const void* data, std::size_t size) {
  * deterministic scalar value for the proof system without relying on any
  * training logic.
  */
-inline float compute_loss(const std::vector<std::vector<int8_t>>& tensors) {
-    if (tensors.size() < 2)
+inline float compute_loss(const TensorView* tensors, std::size_t count) {
+    if (count < 2)
         return 0.0f;
 
-    const auto& pred = tensors[0];
-    const auto& target = tensors[1];
-    if (pred.size() < 6 || target.size() < 6)
+    const TensorView pred = tensors[0];
+    const TensorView target = tensors[1];
+    if (pred.size < 6 || target.size < 6)
         return 0.0f;
 
     // Cross-entropy over move logits (first 4 values).
-    float max_logit = static_cast<float>(*std::max_element(pred.begin(), pred.begin() + 4));
+    float max_logit = static_cast<float>(*std::max_element(pred.data, pred.data + 4));
     float exp_sum = 0.0f;
     float probs[4];
     for (int i = 0; i < 4; ++i) {
@@ -96,10 +115,21 @@ inline float compute_loss(const std::vector<std::vector<int8_t>>& tensors) {
     return ce + mse + bce;
 }
 
+inline float compute_loss(const std::vector<std::vector<int8_t>>& tensors) {
+    if (tensors.size() < 2)
+        return 0.0f;
+    const TensorView views[2] = {{tensors[0].data(), tensors[0].size()},
+                                 {tensors[1].data(), tensors[1].size()}};
+    return compute_loss(views, 2);
+}
+
 struct StarkProof {
     std::string root;
     std::string proof;
     float loss{0.0f};
+
+    /** ``root`` as a binary key; see ``Digest32::from_root``. */
+    Digest32 root_digest() const { return Digest32::from_root(root); }
 };
 
 class IProofSystem {
@@ -108,6 +138,30 @@ class IProofSystem {
     virtual StarkProof generate_proof(const std::vector<std::vector<int8_t>>& tensors) const = 0;
     virtual bool verify_proof(const std::vector<std::vector<int8_t>>& tensors,
                               const StarkProof& proof) const = 0;
+
+    /**
+     * Prove ``count`` tensors given as views into caller-owned memory. The
+     * default copies them into vectors; implementations override this to
+     * read the views in place.
+     */
+    virtual StarkProof generate_proof(const TensorView* tensors, std::size_t count) const {
+        return generate_proof(materialize(tensors, count));
+    }
+
+    virtual bool verify_proof(const TensorView* tensors, std::size_t count,
+                              const StarkProof& proof) const {
+        return verify_proof(materialize(tensors, count), proof);
+    }
+
+  private:
+    static std::vector<std::vector<int8_t>> materialize(const TensorView* tensors,
+                                                        std::size_t count) {
+        std::vector<std::vector<int8_t>> out;
+        out.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            out.emplace_back(tensors[i].data, tensors[i].data + tensors[i].size);
+        return out;
+    }
 };
 
 class Blake3ProofSystem : public IProofSystem {
@@ -124,22 +178,27 @@ class Blake3ProofSystem : public IProofSystem {
      * well as their contents. The resulting root is hashed again to derive the
      * proof field. A simple loss metric is attached using ``compute_loss``.
      */
-    StarkProof generate_proof(const std::vector<std::vector<int8_t>>& tensors) const override {
+    StarkProof generate_proof(const TensorView* tensors, std::size_t count) const override {
         blake3_hasher hasher;
         blake3_hasher_init(&hasher);
-        for (const auto& t : tensors) {
-            if (!t.empty())
-                blake3_hasher_update(&hasher, t.data(), t.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            if (tensors[i].size)
+                blake3_hasher_update(&hasher, tensors[i].data, tensors[i].size);
         }
         uint8_t out[BLAKE3_OUT_LEN];
         blake3_hasher_finalize(&hasher, out, BLAKE3_OUT_LEN);
         StarkProof p{};
         p.root = to_hex(out, BLAKE3_OUT_LEN);
         p.proof = blake3_digest(p.root.data(), p.root.size());
-        p.loss = compute_loss(tensors);
+        p.loss = compute_loss(tensors, count);
         return p;
     }
 
+    StarkProof generate_proof(const std::vector<std::vector<int8_t>>& tensors) const override {
+        auto views = tensor_views(tensors);
+        return generate_proof(views.data(), views.size());
+    }
+
     /**
      * @brief Recompute the proof and compare it against the provided one.
      *
@@ -147,9 +206,9 @@ class Blake3ProofSystem : public IProofSystem {
      * ``generate_proof``. Both the root hash and the embedded loss value must
      * match in order for verification to succeed.
      */
-    bool verify_proof(const std::vector<std::vector<int8_t>>& tensors,
+    bool verify_proof(const TensorView* tensors, std::size_t count,
                       const StarkProof& proof) const override {
-        auto expected = generate_proof(tensors);
+        auto expected = generate_proof(tensors, count);
         if (expected.root != proof.root)
             return false;
         if (expected.loss != proof.loss)
@@ -157,6 +216,12 @@ class Blake3ProofSystem : public IProofSystem {
         return blake3_digest(proof.root.data(), proof.root.size()) == proof.proof;
     }
 
+    bool verify_proof(const std::vector<std::vector<int8_t>>& tensors,
+                      const StarkProof& proof) const override {
+        auto views = tensor_views(tensors);
+        return verify_proof(views.data(), views.size(), proof);
+    }
+
   private:
     Blake3ProofSystem() = default;
 };
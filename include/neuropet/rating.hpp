@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "neuropet/match_ledger.hpp"
+
+namespace neuropet {
+
+/**
+ * @brief Elo ratings derived from ``MatchLedger`` results.
+ *
+ * ``sync`` applies only the results recorded since the previous call, so
+ * keeping ratings current costs O(new results) rather than a full replay.
+ */
+class EloRatings {
+  public:
+    explicit EloRatings(double initial = 1500.0, double k = 32.0) : initial_{initial}, k_{k} {}
+
+    /** Current rating of ``id``; unrated creatures start at the initial rating. */
+    double rating(std::uint32_t id) const {
+        auto it = ratings_.find(id);
+        return it == ratings_.end() ? initial_ : it->second;
+    }
+
+    /** Probability that a creature rated ``a`` beats one rated ``b``. */
+    static double expected_score(double a, double b) {
+        return 1.0 / (1.0 + std::pow(10.0, (b - a) / 400.0));
+    }
+
+    /** Apply a single result. */
+    void update(std::uint32_t winner, std::uint32_t loser) {
+        double rw = rating(winner);
+        double rl = rating(loser);
+        double delta = k_ * (1.0 - expected_score(rw, rl));
+        ratings_[winner] = rw + delta;
+        ratings_[loser] = rl - delta;
+    }
+
+    /** Apply every ledger result recorded since the last sync; returns how many. */
+    std::size_t sync(const MatchLedger& ledger) {
+        const auto& results = ledger.results();
+        std::size_t applied = 0;
+        for (; synced_ < results.size(); ++synced_, ++applied)
+            update(results[synced_].winner, results[synced_].loser);
+        return applied;
+    }
+
+    /** Number of creatures with at least one rated result. */
+    std::size_t size() const { return ratings_.size(); }
+
+  private:
+    double initial_{1500.0};
+    double k_{32.0};
+    std::unordered_map<std::uint32_t, double> ratings_{};
+    std::size_t synced_{0};
+};
+
+} // namespace neuropet
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace neuropet {
+
+/**
+ * @brief Growable FIFO ring buffer.
+ *
+ * ``push_back`` and ``pop_front`` are O(1); storage doubles when full and is
+ * never shrunk, so a queue that is drained and refilled stops allocating once
+ * it reached its working size.
+ */
+template <class T> class RingQueue {
+  public:
+    void push_back(const T& v) {
+        if (size_ == buf_.size())
+            grow();
+        buf_[(head_ + size_) & (buf_.size() - 1)] = v;
+        ++size_;
+    }
+
+    const T& front() const { return buf_[head_]; }
+
+    void pop_front() {
+        head_ = (head_ + 1) & (buf_.size() - 1);
+        --size_;
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return buf_.size(); }
+
+  private:
+    void grow() {
+        std::vector<T> next(buf_.empty() ? 16 : buf_.size() * 2);
+        for (std::size_t i = 0; i < size_; ++i)
+            next[i] = std::move(buf_[(head_ + i) & (buf_.size() - 1)]);
+        buf_ = std::move(next);
+        head_ = 0;
+    }
+
+    std::vector<T> buf_{};
+    std::size_t head_{0};
+    std::size_t size_{0};
+};
+
+} // namespace neuropet
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <random>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "neuropet/battle.hpp"
 #include "neuropet/match_ledger.hpp"
+#include "neuropet/parallel.hpp"
 #include "neuropet/training.hpp"
 
 namespace neuropet {
@@ -14,8 +19,40 @@ struct NullStreamer {
     void push(const TrainingMetrics&) {}
 };
 
+/**
+ * @brief Counter-based random stream for reproducible parallel simulation.
+ *
+ * Output ``n`` is a SplitMix64 hash of ``n`` and a key derived from the
+ * master seed and a stream id, so any stream can be generated on any thread
+ * without touching shared state. Satisfies ``UniformRandomBitGenerator``.
+ */
+class StreamRng {
+  public:
+    using result_type = std::uint32_t;
+
+    StreamRng(std::uint64_t seed, std::uint64_t stream)
+        : key_{mix(mix(seed) ^ (stream * 0x9E3779B97F4A7C15ull + 1))} {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    result_type operator()() {
+        return static_cast<result_type>(mix(key_ + ++counter_ * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+  private:
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t key_{0};
+    std::uint64_t counter_{0};
+};
+
 /** Generate a random creature with power, defense and stamina in [1, 10]. */
-inline CreatureStats random_creature(std::uint32_t id, std::mt19937& rng) {
+template <class Rng> inline CreatureStats random_creature(std::uint32_t id, Rng& rng) {
     std::uniform_int_distribution<int> stat(1, 10);
     CreatureStats c{id, stat(rng), stat(rng), stat(rng)};
     return c;
@@ -54,4 +91,56 @@ inline void run_simulation(std::size_t creature_count, std::size_t steps, std::s
     }
 }
 
+/**
+ * Parallel variant of ``run_simulation`` with reproducible output.
+ *
+ * Creature ``i`` draws its stats from stream ``2 * i`` and battle ``j`` draws
+ * its pairing and fight seed from stream ``2 * j + 1`` of ``StreamRng(seed)``.
+ * Training and battles run on up to ``threads`` workers (zero uses all
+ * cores) and results are recorded in battle order, so the ledger is the same
+ * for every thread count. Concurrent training only shares harmonics state
+ * through shader registration and graph construction, which
+ * ``TrainingPipeline`` serializes.
+ * @param creature_count Number of creatures to spawn
+ * @param steps Training steps per creature
+ * @param battles Number of battles to run
+ * @param ledger Ledger recording battle results
+ * @param seed Master seed for all random streams
+ * @param threads Worker threads; zero selects all hardware threads
+ */
+inline void run_simulation(std::size_t creature_count, std::size_t steps, std::size_t battles,
+                           MatchLedger& ledger, std::uint64_t seed, unsigned threads = 0) {
+    if (battles && creature_count < 2)
+        throw std::runtime_error("simulation needs at least two creatures to battle");
+    std::vector<CreatureStats> creatures(creature_count);
+    parallel_for(creature_count, threads, [&](std::size_t i) {
+        StreamRng rng(seed, 2 * i);
+        creatures[i] = random_creature(static_cast<std::uint32_t>(i + 1), rng);
+        NullStreamer ns;
+        train_with_metrics(steps, ns);
+    });
+
+    // Battles are handed out in blocks to keep scheduling overhead off the
+    // hot loop; each one only writes its own result slot.
+    constexpr std::size_t block = 1024;
+    BattleEngine engine;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> results(battles);
+    parallel_for((battles + block - 1) / block, threads, [&](std::size_t blk) {
+        std::size_t end = std::min(battles, (blk + 1) * block);
+        for (std::size_t i = blk * block; i < end; ++i) {
+            StreamRng rng(seed, 2 * i + 1);
+            std::uniform_int_distribution<std::size_t> dist(0, creature_count - 1);
+            std::size_t a = dist(rng);
+            std::size_t b = dist(rng);
+            while (a == b)
+                b = dist(rng);
+            std::uint32_t winner = engine.fight(creatures[a], creatures[b], rng());
+            std::uint32_t loser = winner == creatures[a].id ? creatures[b].id : creatures[a].id;
+            results[i] = {winner, loser};
+        }
+    });
+    for (const auto& r : results)
+        ledger.record_result(r.first, r.second);
+}
+
 } // namespace neuropet
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "neuropet/battle.hpp"
+#include "neuropet/match_ledger.hpp"
+#include "neuropet/rating.hpp"
+
+namespace neuropet {
+
+/** Tuning knobs for ``SkillMatchmaker``. */
+struct SkillMatchmakerOptions {
+    /// Rating difference accepted for a creature that just joined.
+    double base_window{50.0};
+    /// Additional rating difference accepted per second of waiting.
+    double widen_per_second{25.0};
+    /// Upper bound on the accepted rating difference.
+    double max_window{400.0};
+    /// Seed passed to every fight, as in ``Matchmaker::try_match``.
+    std::uint32_t seed{0};
+};
+
+/**
+ * @brief Matchmaker pairing creatures of similar Elo rating.
+ *
+ * Waiting creatures are kept in a treap ordered by rating. A creature with
+ * rating ``y`` that joined at time ``j`` accepts an opponent above it while
+ * ``d <= base_window + widen_per_second * (now - j)``, i.e. while
+ * ``y + widen_per_second * j`` stays below a bound that depends only on the
+ * newcomer and ``now``; the mirror key covers opponents below. Subtrees cache
+ * the minimum of both keys, so ``enqueue`` finds the closest creature whose
+ * rating difference fits the search window of either side with a few
+ * ``O(log n)`` descents, however long anyone has waited. Windows grow with
+ * waiting time, and ``tick`` pairs neighbours whose windows have widened
+ * enough since they joined. Ratings follow the ledger results.
+ */
+class SkillMatchmaker {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SkillMatchmaker(const BattleEngine& engine = BattleEngine(),
+                             MatchLedger* ledger = nullptr, SkillMatchmakerOptions opts = {})
+        : engine_{engine}, ledger_{ledger}, opts_{opts}, pool_{opts.widen_per_second} {}
+
+    /**
+     * Add a creature and fight the best waiting opponent if one is in range.
+     * @return winner id or empty if the creature keeps waiting.
+     */
+    std::optional<std::uint32_t> enqueue(const CompactCreature& creature,
+                                         Clock::time_point now = Clock::now()) {
+        Entry entry{creature, now};
+        const double r = rating(creature.id);
+        const double own = window(entry, now);
+        const double bound = opts_.base_window + opts_.widen_per_second * seconds(now);
+        // Stale entries of the same creature can never be its opponent.
+        pool_.hide(creature.id);
+        // The nearest creature on each side wins if it fits the newcomer's
+        // window; otherwise only the waiting creature's own window can help.
+        int above = pool_.successor(r);
+        if (above >= 0 && pool_.rating(above) - r > own)
+            above = pool_.first_above(r, r + bound);
+        if (above >= 0 && pool_.rating(above) - r > opts_.max_window)
+            above = -1;
+        int below = pool_.predecessor(r);
+        if (below >= 0 && r - pool_.rating(below) > own)
+            below = pool_.last_below(r, bound - r);
+        if (below >= 0 && r - pool_.rating(below) > opts_.max_window)
+            below = -1;
+        pool_.show(creature.id);
+        int best = above;
+        if (below >= 0 && (best < 0 || r - pool_.rating(below) < pool_.rating(best) - r))
+            best = below;
+        if (best < 0) {
+            pool_.insert(entry, r, seconds(now));
+            return std::nullopt;
+        }
+        CompactCreature opponent = pool_.entry(best).creature;
+        pool_.erase(best);
+        return fight(opponent, creature);
+    }
+
+    std::optional<std::uint32_t> enqueue(const CreatureStats& creature,
+                                         Clock::time_point now = Clock::now()) {
+        return enqueue(CompactCreature(creature), now);
+    }
+
+    /**
+     * Pair rating neighbours whose widened windows now overlap. Call
+     * periodically; returns the number of matches played.
+     */
+    std::size_t tick(Clock::time_point now = Clock::now()) {
+        std::size_t played = 0;
+        std::vector<int> order = pool_.in_order();
+        for (std::size_t i = 0; i + 1 < order.size();) {
+            const Entry& a = pool_.entry(order[i]);
+            const Entry& b = pool_.entry(order[i + 1]);
+            double diff = pool_.rating(order[i + 1]) - pool_.rating(order[i]);
+            if (a.creature.id != b.creature.id &&
+                diff <= std::max(window(a, now), window(b, now))) {
+                CompactCreature ca = a.creature;
+                CompactCreature cb = b.creature;
+                pool_.erase(order[i]);
+                pool_.erase(order[i + 1]);
+                fight(ca, cb);
+                ++played;
+                i += 2;
+            } else {
+                ++i;
+            }
+        }
+        return played;
+    }
+
+    /** Current rating of ``id``. */
+    double rating(std::uint32_t id) {
+        if (ledger_)
+            ratings_.sync(*ledger_);
+        return ratings_.rating(id);
+    }
+
+    /** Number of creatures waiting for an opponent. */
+    std::size_t pending() const { return pool_.size(); }
+
+  private:
+    struct Entry {
+        CompactCreature creature{};
+        Clock::time_point joined{};
+    };
+
+    /**
+     * Treap keyed by ``(rating, arrival)``. Each node holds the keys
+     * ``rating + widen * joined`` and ``widen * joined - rating`` and the
+     * minimum of each over its subtree, which prunes window searches.
+     */
+    class RatingPool {
+      public:
+        explicit RatingPool(double widen) : widen_{widen} {}
+
+        std::size_t size() const { return size_; }
+        double rating(int n) const { return nodes_[n].rating; }
+        const Entry& entry(int n) const { return nodes_[n].entry; }
+
+        int insert(const Entry& e, double rating, double joined) {
+            int n;
+            if (free_.empty()) {
+                n = static_cast<int>(nodes_.size());
+                nodes_.emplace_back();
+            } else {
+                n = free_.back();
+                free_.pop_back();
+            }
+            Node& node = nodes_[n];
+            node.entry = e;
+            node.rating = rating;
+            node.seq = seq_++;
+            node.up = rating + widen_ * joined;
+            node.down = widen_ * joined - rating;
+            node.prio = static_cast<std::uint32_t>(rng_());
+            ids_[e.creature.id].push_back(n);
+            link(n);
+            ++size_;
+            return n;
+        }
+
+        void erase(int n) {
+            root_ = unlink(root_, n);
+            auto it = ids_.find(nodes_[n].entry.creature.id);
+            it->second.erase(std::find(it->second.begin(), it->second.end(), n));
+            if (it->second.empty())
+                ids_.erase(it);
+            free_.push_back(n);
+            --size_;
+        }
+
+        /** Temporarily take every entry of ``id`` out of the tree. */
+        void hide(std::uint32_t id) {
+            auto it = ids_.find(id);
+            if (it != ids_.end())
+                for (int n : it->second)
+                    root_ = unlink(root_, n);
+        }
+
+        void show(std::uint32_t id) {
+            auto it = ids_.find(id);
+            if (it != ids_.end())
+                for (int n : it->second)
+                    link(n);
+        }
+
+        /** First node rated at least ``r``, or -1. */
+        int successor(double r) const {
+            int res = -1;
+            for (int t = root_; t >= 0;) {
+                if (nodes_[t].rating >= r) {
+                    res = t;
+                    t = nodes_[t].left;
+                } else {
+                    t = nodes_[t].right;
+                }
+            }
+            return res;
+        }
+
+        /** Last node rated below ``r``, or -1. */
+        int predecessor(double r) const {
+            int res = -1;
+            for (int t = root_; t >= 0;) {
+                if (nodes_[t].rating < r) {
+                    res = t;
+                    t = nodes_[t].right;
+                } else {
+                    t = nodes_[t].left;
+                }
+            }
+            return res;
+        }
+
+        /** First node rated at least ``r`` whose up key is at most ``bound``. */
+        int first_above(double r, double bound) const { return first_above(root_, r, bound); }
+
+        /** Last node rated below ``r`` whose down key is at most ``bound``. */
+        int last_below(double r, double bound) const { return last_below(root_, r, bound); }
+
+        std::vector<int> in_order() const {
+            std::vector<int> out;
+            out.reserve(size_);
+            std::vector<int> stack;
+            for (int t = root_; t >= 0 || !stack.empty();) {
+                for (; t >= 0; t = nodes_[t].left)
+                    stack.push_back(t);
+                t = stack.back();
+                stack.pop_back();
+                out.push_back(t);
+                t = nodes_[t].right;
+            }
+            return out;
+        }
+
+      private:
+        struct Node {
+            Entry entry{};
+            double rating{0.0};
+            std::uint64_t seq{0};
+            double up{0.0};
+            double down{0.0};
+            double min_up{0.0};
+            double min_down{0.0};
+            std::uint32_t prio{0};
+            int left{-1};
+            int right{-1};
+        };
+
+        bool before(int a, int b) const {
+            const Node& x = nodes_[a];
+            const Node& y = nodes_[b];
+            return x.rating < y.rating || (x.rating == y.rating && x.seq < y.seq);
+        }
+
+        void pull(int t) {
+            Node& n = nodes_[t];
+            n.min_up = n.up;
+            n.min_down = n.down;
+            for (int c : {n.left, n.right})
+                if (c >= 0) {
+                    n.min_up = std::min(n.min_up, nodes_[c].min_up);
+                    n.min_down = std::min(n.min_down, nodes_[c].min_down);
+                }
+        }
+
+        /** Split ``t`` into nodes ordered before ``key`` and the rest. */
+        void split(int t, int key, int& l, int& r) {
+            if (t < 0) {
+                l = r = -1;
+            } else if (before(t, key)) {
+                split(nodes_[t].right, key, nodes_[t].right, r);
+                l = t;
+                pull(t);
+            } else {
+                split(nodes_[t].left, key, l, nodes_[t].left);
+                r = t;
+                pull(t);
+            }
+        }
+
+        int merge(int l, int r) {
+            if (l < 0 || r < 0)
+                return l < 0 ? r : l;
+            if (nodes_[l].prio > nodes_[r].prio) {
+                nodes_[l].right = merge(nodes_[l].right, r);
+                pull(l);
+                return l;
+            }
+            nodes_[r].left = merge(l, nodes_[r].left);
+            pull(r);
+            return r;
+        }
+
+        void link(int n) {
+            nodes_[n].left = nodes_[n].right = -1;
+            pull(n);
+            int l, r;
+            split(root_, n, l, r);
+            root_ = merge(merge(l, n), r);
+        }
+
+        int unlink(int t, int n) {
+            if (t == n)
+                return merge(nodes_[t].left, nodes_[t].right);
+            if (before(n, t))
+                nodes_[t].left = unlink(nodes_[t].left, n);
+            else
+                nodes_[t].right = unlink(nodes_[t].right, n);
+            pull(t);
+            return t;
+        }
+
+        int first_above(int t, double r, double bound) const {
+            if (t < 0 || nodes_[t].min_up > bound)
+                return -1;
+            const Node& n = nodes_[t];
+            if (n.rating < r)
+                return first_above(n.right, r, bound);
+            int res = first_above(n.left, r, bound);
+            if (res >= 0)
+                return res;
+            return n.up <= bound ? t : first_above(n.right, r, bound);
+        }
+
+        int last_below(int t, double r, double bound) const {
+            if (t < 0 || nodes_[t].min_down > bound)
+                return -1;
+            const Node& n = nodes_[t];
+            if (n.rating >= r)
+                return last_below(n.left, r, bound);
+            int res = last_below(n.right, r, bound);
+            if (res >= 0)
+                return res;
+            return n.down <= bound ? t : last_below(n.left, r, bound);
+        }
+
+        double widen_{0.0};
+        std::vector<Node> nodes_{};
+        std::vector<int> free_{};
+        std::unordered_map<std::uint32_t, std::vector<int>> ids_{};
+        std::mt19937 rng_{0x5eed};
+        std::uint64_t seq_{0};
+        std::size_t size_{0};
+        int root_{-1};
+    };
+
+    static double seconds(Clock::time_point t) {
+        return std::chrono::duration<double>(t.time_since_epoch()).count();
+    }
+
+    double window(const Entry& e, Clock::time_point now) const {
+        double waited = std::chrono::duration<double>(now - e.joined).count();
+        return std::min(opts_.max_window,
+                        opts_.base_window + opts_.widen_per_second * std::max(waited, 0.0));
+    }
+
+    std::uint32_t fight(const CompactCreature& a, const CompactCreature& b) {
+        std::uint32_t winner = engine_.fight(a, b, opts_.seed);
+        std::uint32_t loser = winner == a.id ? b.id : a.id;
+        if (ledger_) {
+            ledger_->record_result(winner, loser);
+            ratings_.sync(*ledger_);
+        } else {
+            ratings_.update(winner, loser);
+        }
+        return winner;
+    }
+
+    BattleEngine engine_{};
+    MatchLedger* ledger_{};
+    SkillMatchmakerOptions opts_{};
+    EloRatings ratings_{};
+    RatingPool pool_;
+};
+
+} // namespace neuropet
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "neuropet/battle.hpp"
+#include "neuropet/match_ledger.hpp"
+#include "neuropet/parallel.hpp"
+
+namespace neuropet {
+
+/** Bracket formats supported by ``TournamentEngine``. */
+enum class TournamentFormat { SingleElimination, Swiss, RoundRobin };
+
+/** Tuning knobs for ``TournamentEngine``. */
+struct TournamentOptions {
+    TournamentFormat format{TournamentFormat::SingleElimination};
+    /// Swiss rounds to play; zero plays ``ceil(log2(entrants))``.
+    std::size_t swiss_rounds{0};
+    /// Seed passed to every fight, as in ``Matchmaker::try_match``.
+    std::uint32_t seed{0};
+    /// Worker threads per round; zero selects all hardware threads.
+    unsigned threads{0};
+};
+
+/** A single fight of a tournament round. */
+struct TournamentMatch {
+    std::uint32_t a{0};
+    std::uint32_t b{0};
+    std::uint32_t winner{0};
+};
+
+/** Matches of one round in pairing order. */
+struct TournamentRound {
+    std::vector<TournamentMatch> matches{};
+    /// Creature receiving a bye this round, or 0.
+    std::uint32_t bye{0};
+};
+
+/** Outcome of ``TournamentEngine::run``. */
+struct TournamentResult {
+    std::vector<TournamentRound> rounds{};
+    /// Creature ids ordered best first.
+    std::vector<std::uint32_t> standings{};
+    /// Wins per creature, parallel to ``standings``.
+    std::vector<std::uint32_t> scores{};
+    /**
+     * Creature ids of the winner lists for ``Tournament.reportWinners``, one
+     * call at a time. Single elimination reports the creatures advancing from
+     * every round; Swiss and round-robin report the champion once, which
+     * finishes the bracket on chain.
+     */
+    std::vector<std::vector<std::uint32_t>> report_ids{};
+
+    std::uint32_t champion() const { return standings.empty() ? 0 : standings.front(); }
+
+    /**
+     * ``report_ids`` translated into the ``address[]`` payloads the contract
+     * takes. ``address_of`` maps a creature id to the player address it
+     * entered the bracket with.
+     */
+    std::vector<std::vector<std::string>>
+    reports(const std::function<std::string(std::uint32_t)>& address_of) const {
+        std::vector<std::vector<std::string>> out;
+        out.reserve(report_ids.size());
+        for (const auto& ids : report_ids) {
+            std::vector<std::string> winners;
+            winners.reserve(ids.size());
+            for (std::uint32_t id : ids)
+                winners.push_back(address_of(id));
+            out.push_back(std::move(winners));
+        }
+        return out;
+    }
+};
+
+/**
+ * @brief Off-chain bracket simulation mirroring ``contracts/Tournament.sol``.
+ *
+ * Every round is paired up front and its fights, which are independent, run
+ * on up to ``threads`` workers before the results are recorded in pairing
+ * order. Pairings only depend on previous results, so the outcome, the
+ * ledger and the ``reportWinners`` payloads are the same for every thread
+ * count.
+ *
+ * - Single elimination pairs neighbours in bracket order; an odd creature out
+ *   at the end of a round advances on a bye.
+ * - Swiss pairs creatures of equal score in standings order, avoiding
+ *   rematches where possible; an odd creature out gets a bye worth a win,
+ *   at most once per creature where possible.
+ * - Round-robin schedules every pair exactly once with the circle method.
+ *
+ * Standings rank creatures by wins, then by entry order.
+ */
+class TournamentEngine {
+  public:
+    explicit TournamentEngine(const BattleEngine& engine = BattleEngine(),
+                              MatchLedger* ledger = nullptr, TournamentOptions opts = {})
+        : engine_{engine}, ledger_{ledger}, opts_{opts} {}
+
+    void set_ledger(MatchLedger* ledger) { ledger_ = ledger; }
+
+    /** Run a full tournament; throws if fewer than two creatures enter. */
+    TournamentResult run(const std::vector<CompactCreature>& entrants) {
+        if (entrants.size() < 2)
+            throw std::runtime_error("tournament needs at least two entrants");
+        switch (opts_.format) {
+        case TournamentFormat::Swiss:
+            return swiss(entrants);
+        case TournamentFormat::RoundRobin:
+            return round_robin(entrants);
+        case TournamentFormat::SingleElimination:
+        default:
+            return single_elimination(entrants);
+        }
+    }
+
+    TournamentResult run(const std::vector<CreatureStats>& entrants) {
+        return run(std::vector<CompactCreature>(entrants.begin(), entrants.end()));
+    }
+
+  private:
+    using Pairing = std::pair<std::size_t, std::size_t>;
+
+    /** Fight ``pairs`` of entrant indices in parallel; returns whether ``a`` won. */
+    std::vector<char> play(const std::vector<CompactCreature>& entrants,
+                           const std::vector<Pairing>& pairs, TournamentRound& round) {
+        constexpr std::size_t block = 1024;
+        std::vector<char> a_won(pairs.size());
+        round.matches.resize(pairs.size());
+        parallel_for((pairs.size() + block - 1) / block, opts_.threads, [&](std::size_t blk) {
+            std::size_t end = std::min(pairs.size(), (blk + 1) * block);
+            for (std::size_t i = blk * block; i < end; ++i) {
+                const CompactCreature& a = entrants[pairs[i].first];
+                const CompactCreature& b = entrants[pairs[i].second];
+                std::uint32_t winner = engine_.fight(a, b, opts_.seed);
+                round.matches[i] = {a.id, b.id, winner};
+                a_won[i] = winner == a.id;
+            }
+        });
+        if (ledger_)
+            for (const auto& m : round.matches)
+                ledger_->record_result(m.winner, m.winner == m.a ? m.b : m.a);
+        return a_won;
+    }
+
+    TournamentResult single_elimination(const std::vector<CompactCreature>& entrants) {
+        TournamentResult result;
+        std::vector<std::uint32_t> wins(entrants.size(), 0);
+        std::vector<std::size_t> alive(entrants.size());
+        std::iota(alive.begin(), alive.end(), std::size_t{0});
+        // Rank of elimination: creatures knocked out later place higher.
+        std::vector<std::size_t> out_round(entrants.size(), 0);
+        std::size_t round_no = 0;
+        while (alive.size() > 1) {
+            ++round_no;
+            std::vector<Pairing> pairs;
+            pairs.reserve(alive.size() / 2);
+            for (std::size_t i = 0; i + 1 < alive.size(); i += 2)
+                pairs.emplace_back(alive[i], alive[i + 1]);
+            TournamentRound round;
+            auto a_won = play(entrants, pairs, round);
+            std::vector<std::size_t> next;
+            next.reserve((alive.size() + 1) / 2);
+            for (std::size_t i = 0; i < pairs.size(); ++i) {
+                std::size_t w = a_won[i] ? pairs[i].first : pairs[i].second;
+                std::size_t l = a_won[i] ? pairs[i].second : pairs[i].first;
+                ++wins[w];
+                out_round[l] = round_no;
+                next.push_back(w);
+            }
+            if (alive.size() % 2) {
+                round.bye = entrants[alive.back()].id;
+                next.push_back(alive.back());
+            }
+            std::vector<std::uint32_t> report;
+            report.reserve(next.size());
+            for (std::size_t i : next)
+                report.push_back(entrants[i].id);
+            result.report_ids.push_back(std::move(report));
+            result.rounds.push_back(std::move(round));
+            alive = std::move(next);
+        }
+        out_round[alive.front()] = round_no + 1;
+        std::vector<std::size_t> order(entrants.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+            if (out_round[x] != out_round[y])
+                return out_round[x] > out_round[y];
+            return wins[x] > wins[y];
+        });
+        fill_standings(result, entrants, order, wins);
+        return result;
+    }
+
+    TournamentResult swiss(const std::vector<CompactCreature>& entrants) {
+        const std::size_t n = entrants.size();
+        std::size_t rounds = opts_.swiss_rounds;
+        if (!rounds)
+            while ((std::size_t{1} << rounds) < n)
+                ++rounds;
+        TournamentResult result;
+        std::vector<std::uint32_t> wins(n, 0);
+        std::vector<char> had_bye(n, 0);
+        History faced(n, rounds);
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        for (std::size_t r = 0; r < rounds; ++r) {
+            rank(order, wins);
+            TournamentRound round;
+            std::vector<std::size_t> pool = order;
+            if (n % 2) {
+                // Lowest ranked creature without a bye sits out.
+                std::size_t pick = pool.size() - 1;
+                for (std::size_t k = pool.size(); k-- > 0;)
+                    if (!had_bye[pool[k]]) {
+                        pick = k;
+                        break;
+                    }
+                std::size_t bye = pool[pick];
+                pool.erase(pool.begin() + static_cast<std::ptrdiff_t>(pick));
+                had_bye[bye] = 1;
+                ++wins[bye];
+                round.bye = entrants[bye].id;
+            }
+            std::vector<Pairing> pairs;
+            pairs.reserve(pool.size() / 2);
+            std::vector<char> used(pool.size(), 0);
+            for (std::size_t i = 0; i < pool.size(); ++i) {
+                if (used[i])
+                    continue;
+                std::size_t partner = pool.size();
+                for (std::size_t j = i + 1; j < pool.size(); ++j) {
+                    if (used[j])
+                        continue;
+                    if (partner == pool.size())
+                        partner = j;
+                    if (!faced.met(pool[i], pool[j])) {
+                        partner = j;
+                        break;
+                    }
+                }
+                used[i] = used[partner] = 1;
+                pairs.emplace_back(pool[i], pool[partner]);
+            }
+            repair_rematches(pairs, faced);
+            for (const auto& pr : pairs)
+                faced.add(pr.first, pr.second);
+            auto a_won = play(entrants, pairs, round);
+            for (std::size_t i = 0; i < pairs.size(); ++i)
+                ++wins[a_won[i] ? pairs[i].first : pairs[i].second];
+            result.rounds.push_back(std::move(round));
+        }
+        rank(order, wins);
+        fill_standings(result, entrants, order, wins);
+        result.report_ids.push_back({result.champion()});
+        return result;
+    }
+
+    TournamentResult round_robin(const std::vector<CompactCreature>& entrants) {
+        const std::size_t n = entrants.size();
+        // Circle method: slot ``n`` is a phantom opponent meaning a bye.
+        const std::size_t slots = n + (n % 2);
+        std::vector<std::size_t> circle(slots);
+        std::iota(circle.begin(), circle.end(), std::size_t{0});
+        TournamentResult result;
+        std::vector<std::uint32_t> wins(n, 0);
+        for (std::size_t r = 0; r + 1 < slots; ++r) {
+            TournamentRound round;
+            std::vector<Pairing> pairs;
+            pairs.reserve(slots / 2);
+            for (std::size_t i = 0; i < slots / 2; ++i) {
+                std::size_t x = circle[i];
+                std::size_t y = circle[slots - 1 - i];
+                if (x == n || y == n)
+                    round.bye = entrants[x == n ? y : x].id;
+                else
+                    pairs.emplace_back(x, y);
+            }
+            auto a_won = play(entrants, pairs, round);
+            for (std::size_t i = 0; i < pairs.size(); ++i)
+                ++wins[a_won[i] ? pairs[i].first : pairs[i].second];
+            result.rounds.push_back(std::move(round));
+            std::rotate(circle.begin() + 1, circle.end() - 1, circle.end());
+        }
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        rank(order, wins);
+        fill_standings(result, entrants, order, wins);
+        result.report_ids.push_back({result.champion()});
+        return result;
+    }
+
+    /** Opponents met so far, stored flat with one row per creature. */
+    class History {
+      public:
+        History(std::size_t n, std::size_t rounds)
+            : stride_{rounds}, seen_(n * rounds), count_(n, 0) {}
+
+        bool met(std::size_t x, std::size_t y) const {
+            const std::size_t* row = seen_.data() + x * stride_;
+            return std::find(row, row + count_[x], y) != row + count_[x];
+        }
+
+        void add(std::size_t x, std::size_t y) {
+            seen_[x * stride_ + count_[x]++] = y;
+            seen_[y * stride_ + count_[y]++] = x;
+        }
+
+      private:
+        std::size_t stride_{0};
+        std::vector<std::size_t> seen_{};
+        std::vector<std::size_t> count_{};
+    };
+
+    /**
+     * Greedy pairing can strand two creatures that already met at the end of
+     * the list; swap partners with the nearest earlier pair that makes both
+     * pairings fresh.
+     */
+    static void repair_rematches(std::vector<Pairing>& pairs,
+                                 const History& faced) {
+        for (std::size_t i = pairs.size(); i-- > 0;) {
+            auto& p = pairs[i];
+            if (!faced.met(p.first, p.second))
+                continue;
+            for (std::size_t j = i; j-- > 0;) {
+                auto& q = pairs[j];
+                if (!faced.met(p.first, q.second) && !faced.met(q.first, p.second)) {
+                    std::swap(p.second, q.second);
+                    break;
+                }
+                if (!faced.met(p.first, q.first) && !faced.met(q.second, p.second)) {
+                    std::swap(p.second, q.first);
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * Order entrant indices by wins, breaking ties by entry order. Scores are
+     * small integers, so a counting sort keeps this linear.
+     */
+    static void rank(std::vector<std::size_t>& order, const std::vector<std::uint32_t>& wins) {
+        std::uint32_t top = 0;
+        for (std::uint32_t w : wins)
+            top = std::max(top, w);
+        std::vector<std::size_t> start(top + 2, 0);
+        for (std::uint32_t w : wins)
+            ++start[top - w + 1];
+        for (std::size_t k = 1; k < start.size(); ++k)
+            start[k] += start[k - 1];
+        order.resize(wins.size());
+        for (std::size_t i = 0; i < wins.size(); ++i)
+            order[start[top - wins[i]]++] = i;
+    }
+
+    static void fill_standings(TournamentResult& result,
+                               const std::vector<CompactCreature>& entrants,
+                               const std::vector<std::size_t>& order,
+                               const std::vector<std::uint32_t>& wins) {
+        result.standings.reserve(order.size());
+        result.scores.reserve(order.size());
+        for (std::size_t i : order) {
+            result.standings.push_back(entrants[i].id);
+            result.scores.push_back(wins[i]);
+        }
+    }
+
+    BattleEngine engine_{};
+    MatchLedger* ledger_{};
+    TournamentOptions opts_{};
+};
+
+} // namespace neuropet
@@ -8,17 +8,12 @@
 #include "neuropet/int8_kernel.hpp"
 #include "neuropet/int8_spec.hpp"
 #include "neuropet/metrics.hpp"
+#include "neuropet/training_pipeline.hpp"
 #include <harmonics/dataset.hpp>
-#if __has_include(<harmonics/disk_cache_producer.hpp>)
-#include <harmonics/disk_cache_producer.hpp>
-#endif
-#include <fstream>
 #include <harmonics/function_registry.hpp>
-#include <harmonics/graph.hpp>
-#include <harmonics/parser.hpp>
-#include <harmonics/runtime.hpp>
-#include <harmonics/shaders.hpp>
 #include <limits>
+#include <memory>
+#include <string>
 
 namespace neuropet {
 
@@ -72,6 +67,45 @@ inline std::vector<int8_t> eval_network(const Int8Network& net, const std::vecto
     return cur;
 }
 
+/**
+ * Evaluate ``rows`` inputs stacked row-major in ``input`` with one matrix
+ * multiply per layer. Row ``i`` of the result equals
+ * ``eval_network(net, row i)``.
+ */
+inline std::vector<int8_t> eval_network_batch(const Int8Network& net,
+                                              const std::vector<int8_t>& input, std::size_t rows) {
+    std::vector<int8_t> cur = input;
+    std::vector<int8_t> next;
+    for (const auto& l : net.layers) {
+        if (l.op == Int8Op::Dense) {
+            if (cur.size() != rows * l.input)
+                throw std::runtime_error("batch input does not match layer size");
+            int8_matmul_gpu(cur, l.weights, next, rows, l.output, l.input);
+            for (std::size_t r = 0; r < rows; ++r)
+                for (std::size_t i = 0; i < l.output; ++i) {
+                    int8_t& v = next[r * l.output + i];
+                    v = clamp_int8(static_cast<int32_t>(v) + static_cast<int32_t>(l.bias[i]));
+                }
+        } else {
+            next.resize(cur.size());
+            for (std::size_t i = 0; i < cur.size(); ++i)
+                next[i] = cur[i] < 0 ? 0 : cur[i];
+        }
+        cur.swap(next);
+    }
+    return cur;
+}
+
+/** Batched ``run_inference`` over ``rows`` stacked sensor inputs. */
+inline std::vector<int8_t> run_inference_batch(const CreatureModel& model,
+                                               const std::vector<int8_t>& sensor_in,
+                                               std::size_t rows) {
+    enforce_model_size(model);
+    auto s = eval_network_batch(model.sensor, sensor_in, rows);
+    auto c = eval_network_batch(model.core, s, rows);
+    return eval_network_batch(model.appendage, c, rows);
+}
+
 inline std::vector<int8_t> run_inference(const CreatureModel& model,
                                          const std::vector<int8_t>& sensor_in) {
     enforce_model_size(model);
@@ -85,55 +119,13 @@ inline std::vector<int8_t> run_inference(const CreatureModel& model,
  * Executes a tiny HarmonicGraph and reports the gradient norm after each step.
  */
 template <class Streamer> inline void train_with_metrics(std::size_t steps, Streamer& streamer) {
-    using namespace harmonics;
-    register_builtin_shaders();
-
-    const char* src = R"(
-producer input {1};
-producer target {1} 1/1 input;
-layer dense;
-cycle {
-  input -(relu)-> dense;
-  dense <-(mse)- target;
-}
-)";
-
-    Parser parser{src};
-    auto ast = parser.parse_declarations();
-    auto g = build_graph(ast);
-
-    struct ConstProducer : Producer {
-        float value;
-        explicit ConstProducer(float v) : value{v} {}
-        HTensor next() override {
-            HTensor t{HTensor::DType::Float32, {1}};
-            t.data().resize(sizeof(float));
-            *reinterpret_cast<float*>(t.data().data()) = value;
-            return t;
-        }
-        std::size_t size() const override { return 1; }
-    };
-
-    auto inp = std::make_shared<ConstProducer>(1.0f);
-    auto lbl = std::make_shared<ConstProducer>(0.0f);
-    g.bindProducer("input", inp);
-    g.bindProducer("target", lbl);
-
-    FitOptions opt;
-    opt.learning_rate = 0.1f;
-
-    TrainingMetrics m{};
-    std::size_t step = 0;
-    auto stop = [&](const CycleState& state) {
-        float norm = gradients_l2_norm(state.weights);
-        ++step;
-        m.step = static_cast<std::uint32_t>(step);
-        m.loss = norm;
-        streamer.push(m);
-        return step >= steps;
-    };
-
-    g.fit_until(stop, make_auto_policy(), opt);
+    TrainingPipelineConfig cfg;
+    cfg.input = std::make_shared<ConstantProducer>(1.0f, 1);
+    cfg.target = std::make_shared<ConstantProducer>(0.0f, 1);
+    cfg.steps = steps;
+    cfg.metrics = [&streamer](const TrainingMetrics& m) { streamer.push(m); };
+    cfg.auto_policy = true;
+    TrainingPipeline(std::move(cfg)).run();
 }
 
 inline void train_with_metrics(const CreatureModel& model, std::size_t steps,
@@ -152,116 +144,36 @@ inline void train_with_metrics(const CreatureModel& model, std::size_t steps,
  * @brief Run a dataset through a DiskCacheProducer and stream metrics.
  *
  * Each sample is cached on disk under `.harmonics/cache` (or the directory
- * specified by `HARMONICS_CACHE_DIR`). The first float value of each tensor is
- * used as the loss metric for demonstration purposes.
+ * specified by `HARMONICS_CACHE_DIR`). The gradient norm after every step is
+ * reported as the loss metric.
  */
 inline void run_dataset_pipeline(std::shared_ptr<harmonics::Producer> dataset,
                                  const std::string& cache_name, std::size_t steps,
                                  MetricsStreamer& streamer) {
-    using namespace harmonics;
-    register_builtin_shaders();
-
-#if __has_include(<harmonics/disk_cache_producer.hpp>)
-    auto cached = std::make_shared<harmonics::DiskCacheProducer>(dataset, cache_name);
-    std::shared_ptr<harmonics::Producer> src = cached;
-#else
-    (void)cache_name;
-    std::shared_ptr<harmonics::Producer> src = dataset;
-#endif
-
-    const char* src_graph = R"(
-producer input {1};
-producer target {1} 1/1 input;
-layer dense;
-cycle {
-  input -(relu)-> dense;
-  dense <-(mse)- target;
-}
-)";
-
-    Parser parser{src_graph};
-    auto ast = parser.parse_declarations();
-    auto g = build_graph(ast);
-
-    g.bindProducer("input", src);
-
-    struct ZeroProducer : Producer {
-        explicit ZeroProducer(std::size_t n) : n_{n} {}
-        HTensor next() override {
-            HTensor t{HTensor::DType::Float32, {1}};
-            t.data().resize(sizeof(float));
-            *reinterpret_cast<float*>(t.data().data()) = 0.0f;
-            return t;
-        }
-        std::size_t size() const override { return n_; }
-        std::size_t n_{};
-    };
-
-    auto lbl = std::make_shared<ZeroProducer>(src->size());
-    g.bindProducer("target", lbl);
-
-    FitOptions opt;
-    opt.learning_rate = 0.1f;
-
-    TrainingMetrics m{};
-    std::size_t step = 0;
-    auto stop = [&](const CycleState& state) {
-        float norm = gradients_l2_norm(state.weights);
-        ++step;
-        m.step = static_cast<std::uint32_t>(step);
-        m.loss = norm;
-        streamer.push(m);
-        return step >= steps;
-    };
-
-    g.fit_until(stop, make_auto_policy(), opt);
+    TrainingPipelineConfig cfg;
+    cfg.input = std::move(dataset);
+    cfg.input_cache = cache_name;
+    cfg.steps = steps;
+    cfg.metrics = [&streamer](const TrainingMetrics& m) { streamer.push(m); };
+    cfg.auto_policy = true;
+    TrainingPipeline(std::move(cfg)).run();
 }
 
+/** Train on cached input and label sources, streaming metrics every step. */
 inline void production_training_pipeline(std::shared_ptr<harmonics::Producer> input,
                                          std::shared_ptr<harmonics::Producer> target,
                                          const std::string& input_cache,
                                          const std::string& target_cache, std::size_t steps,
                                          MetricsStreamer& streamer) {
-    using namespace harmonics;
-    register_builtin_shaders();
-#if __has_include(<harmonics/disk_cache_producer.hpp>)
-    auto cached_in = std::make_shared<harmonics::DiskCacheProducer>(input, input_cache);
-    auto cached_target = std::make_shared<harmonics::DiskCacheProducer>(target, target_cache);
-    std::shared_ptr<harmonics::Producer> src = cached_in;
-    std::shared_ptr<harmonics::Producer> lbl = cached_target;
-#else
-    (void)input_cache;
-    (void)target_cache;
-    std::shared_ptr<harmonics::Producer> src = input;
-    std::shared_ptr<harmonics::Producer> lbl = target;
-#endif
-    const char* src_graph = R"(
-producer input {1};
-producer target {1} 1/1 input;
-layer dense;
-cycle {
-  input -(relu)-> dense;
-  dense <-(mse)- target;
-}
-)";
-    Parser parser{src_graph};
-    auto ast = parser.parse_declarations();
-    auto g = build_graph(ast);
-    g.bindProducer("input", src);
-    g.bindProducer("target", lbl);
-    FitOptions opt;
-    opt.learning_rate = 0.1f;
-    TrainingMetrics m{};
-    std::size_t step = 0;
-    auto stop = [&](const CycleState& state) {
-        float norm = gradients_l2_norm(state.weights);
-        ++step;
-        m.step = static_cast<std::uint32_t>(step);
-        m.loss = norm;
-        streamer.push(m);
-        return step >= steps;
-    };
-    g.fit_until(stop, make_auto_policy(), opt);
+    TrainingPipelineConfig cfg;
+    cfg.input = std::move(input);
+    cfg.target = std::move(target);
+    cfg.input_cache = input_cache;
+    cfg.target_cache = target_cache;
+    cfg.steps = steps;
+    cfg.metrics = [&streamer](const TrainingMetrics& m) { streamer.push(m); };
+    cfg.auto_policy = true;
+    TrainingPipeline(std::move(cfg)).run();
 }
 
 /**
@@ -277,104 +189,13 @@ inline void run_dataset_checkpoint_pipeline(std::shared_ptr<harmonics::Producer>
                                             const std::string& cache_name,
                                             const std::string& checkpoint_file, std::size_t steps,
                                             MetricsStreamer& streamer) {
-    using namespace harmonics;
-    register_builtin_shaders();
-#if __has_include(<harmonics/disk_cache_producer.hpp>)
-    auto cached = std::make_shared<harmonics::DiskCacheProducer>(dataset, cache_name);
-    std::shared_ptr<harmonics::Producer> src = cached;
-#else
-    (void)cache_name;
-    std::shared_ptr<harmonics::Producer> src = dataset;
-#endif
-
-    const char* src_graph = R"(
-producer input {1};
-producer target {1} 1/1 input;
-layer dense;
-cycle {
-  input -(relu)-> dense;
-  dense <-(mse)- target;
-}
-)";
-
-    Parser parser{src_graph};
-    auto ast = parser.parse_declarations();
-    auto g = build_graph(ast);
-    g.bindProducer("input", src);
-
-    struct ZeroProducer : Producer {
-        explicit ZeroProducer(std::size_t n) : n_{n} {}
-        HTensor next() override {
-            HTensor t{HTensor::DType::Float32, {1}};
-            t.data().resize(sizeof(float));
-            *reinterpret_cast<float*>(t.data().data()) = 0.0f;
-            return t;
-        }
-        std::size_t size() const override { return n_; }
-        std::size_t n_{};
-    };
-
-    auto lbl = std::make_shared<ZeroProducer>(src->size());
-    g.bindProducer("target", lbl);
-
-    CycleRuntime rt{g};
-
-    std::size_t start_step = 0;
-#if __has_include(<harmonics/disk_cache_producer.hpp>)
-    {
-        std::ifstream in(checkpoint_file, std::ios::binary);
-        if (in) {
-            rt.load_checkpoint(in);
-            in.read(reinterpret_cast<char*>(&start_step), sizeof(start_step));
-        }
-    }
-#else
-    (void)checkpoint_file;
-#endif
-
-    FitOptions opt;
-    opt.learning_rate = 0.1f;
-    std::vector<HTensor> params(rt.state().weights.size());
-    std::vector<HTensor> opt1(rt.state().weights.size());
-    std::vector<HTensor> opt2(rt.state().weights.size());
-    TrainingMetrics m{};
-    for (std::size_t i = 0; i < steps; ++i) {
-        rt.forward();
-        float norm = gradients_l2_norm(rt.state().weights);
-        for (std::size_t j = 0; j < params.size(); ++j) {
-            if (!rt.state().weights[j].shape().empty()) {
-                clip_tensor(rt.state().weights[j], opt.grad_clip);
-                switch (opt.optimizer) {
-                case Optimizer::SGD:
-                    apply_sgd_update(params[j], rt.state().weights[j], opt.learning_rate);
-                    break;
-                case Optimizer::Adam:
-                    apply_adam_update(params[j], rt.state().weights[j], opt1[j], opt2[j],
-                                      start_step + i + 1, opt.learning_rate);
-                    break;
-                case Optimizer::RMSProp:
-                    apply_rmsprop_update(params[j], rt.state().weights[j], opt1[j],
-                                         opt.learning_rate);
-                    break;
-                }
-            }
-        }
-        m.step = static_cast<std::uint32_t>(start_step + i + 1);
-        m.loss = norm;
-        streamer.push(m);
-    }
-    rt.state().weights = std::move(params);
-
-#if __has_include(<harmonics/disk_cache_producer.hpp>)
-    {
-        std::ofstream out(checkpoint_file, std::ios::binary);
-        rt.save_checkpoint(out);
-        std::size_t total = start_step + steps;
-        out.write(reinterpret_cast<const char*>(&total), sizeof(total));
-    }
-#else
-    (void)start_step;
-#endif
+    TrainingPipelineConfig cfg;
+    cfg.input = std::move(dataset);
+    cfg.input_cache = cache_name;
+    cfg.checkpoint.path = checkpoint_file;
+    cfg.steps = steps;
+    cfg.metrics = [&streamer](const TrainingMetrics& m) { streamer.push(m); };
+    TrainingPipeline(std::move(cfg)).run();
 }
 
 } // namespace neuropet
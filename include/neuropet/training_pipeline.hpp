@@ -0,0 +1,585 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "neuropet/checkpoint.hpp"
+#include "neuropet/metrics.hpp"
+#include "neuropet/parallel.hpp"
+#include <harmonics/dataset.hpp>
+#if __has_include(<harmonics/disk_cache_producer.hpp>)
+#include <harmonics/disk_cache_producer.hpp>
+#endif
+#include <harmonics/graph.hpp>
+#include <harmonics/parser.hpp>
+#include <harmonics/runtime.hpp>
+#include <harmonics/shaders.hpp>
+
+namespace neuropet {
+
+/**
+ * Register the harmonics builtin shaders once per process. Registration
+ * updates global tables, so concurrent pipelines must not repeat it.
+ */
+inline void register_training_shaders() {
+    static std::once_flag once;
+    std::call_once(once, []() { harmonics::register_builtin_shaders(); });
+}
+
+/**
+ * Lock held while a pipeline parses its graph and creates runtimes. Graph
+ * construction consults harmonics' global registries, which are not
+ * documented as thread-safe; training on the built graphs runs unlocked.
+ */
+inline std::mutex& training_setup_mutex() {
+    static std::mutex m;
+    return m;
+}
+
+/** Graph shared by all training pipelines: one dense layer trained with MSE. */
+inline const char* default_training_graph() {
+    return R"(
+producer input {1};
+producer target {1} 1/1 input;
+layer dense;
+cycle {
+  input -(relu)-> dense;
+  dense <-(mse)- target;
+}
+)";
+}
+
+/** Producer emitting the same scalar value ``n`` times per epoch. */
+struct ConstantProducer : harmonics::Producer {
+    ConstantProducer(float v, std::size_t n) : value{v}, n_{n} {}
+    harmonics::HTensor next() override {
+        harmonics::HTensor t{harmonics::HTensor::DType::Float32, {1}};
+        t.data().resize(sizeof(float));
+        *reinterpret_cast<float*>(t.data().data()) = value;
+        return t;
+    }
+    std::size_t size() const override { return n_; }
+    float value{0.0f};
+    std::size_t n_{};
+};
+
+/**
+ * @brief Read ahead from a base producer on a background thread.
+ *
+ * Up to ``depth`` tensors are buffered so slow sources (HTTP, HDF5, disk
+ * caches) overlap with the forward pass. Samples are returned in exactly the
+ * order the base producer generates them. An exception thrown by the base
+ * producer is rethrown from ``next`` once the samples read before it have
+ * been consumed.
+ */
+class PrefetchProducer : public harmonics::Producer {
+  public:
+    PrefetchProducer(std::shared_ptr<harmonics::Producer> base, std::size_t depth)
+        : base_{std::move(base)}, depth_{depth ? depth : 1}, size_{base_ ? base_->size() : 0} {
+        worker_ = std::thread([this]() { fill(); });
+    }
+
+    ~PrefetchProducer() override {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (worker_.joinable())
+            worker_.join();
+    }
+
+    harmonics::HTensor next() override {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [this]() { return !buffer_.empty() || error_; });
+        if (buffer_.empty())
+            std::rethrow_exception(error_);
+        harmonics::HTensor t = std::move(buffer_.front());
+        buffer_.pop_front();
+        lk.unlock();
+        cv_.notify_all();
+        return t;
+    }
+
+    std::size_t size() const override { return size_; }
+
+  private:
+    void fill() {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                cv_.wait(lk, [this]() { return stop_ || buffer_.size() < depth_; });
+                if (stop_)
+                    return;
+            }
+            harmonics::HTensor t;
+            try {
+                t = base_->next();
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lk(m_);
+                    error_ = std::current_exception();
+                }
+                cv_.notify_all();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                buffer_.push_back(std::move(t));
+            }
+            cv_.notify_all();
+        }
+    }
+
+    std::shared_ptr<harmonics::Producer> base_{};
+    std::size_t depth_{1};
+    std::size_t size_{0};
+    std::deque<harmonics::HTensor> buffer_{};
+    std::mutex m_{};
+    std::condition_variable cv_{};
+    bool stop_{false};
+    std::exception_ptr error_{};
+    std::thread worker_{};
+};
+
+/** Wall-clock seconds spent in each pipeline stage. */
+struct PipelineTimings {
+    double io{0.0};
+    double forward{0.0};
+    double update{0.0};
+    double checkpoint{0.0};
+    double metrics{0.0};
+    std::size_t steps{0};
+
+    double total() const { return io + forward + update + checkpoint + metrics; }
+};
+
+/**
+ * Where, when and whether training state is persisted between runs.
+ * Checkpoints hold parameters, optimizer moments and the global step; data
+ * source positions are not saved, so producers restart from their own
+ * initial state on resume.
+ */
+struct CheckpointPolicy {
+    std::string path{};      ///< empty disables checkpointing
+    bool resume{true};       ///< load ``path`` before training when it exists
+    std::size_t interval{0}; ///< also checkpoint every N global steps; 0 only at the end
+    bool async{true};        ///< serialize on a background thread
+};
+
+inline harmonics::FitOptions default_fit_options() {
+    harmonics::FitOptions opt;
+    opt.learning_rate = 0.1f;
+    return opt;
+}
+
+/** Configuration for ``TrainingPipeline``. */
+struct TrainingPipelineConfig {
+    std::shared_ptr<harmonics::Producer> input{};
+    /// Label source. When null a zero target sized to ``input`` is used.
+    std::shared_ptr<harmonics::Producer> target{};
+    /// ``DiskCacheProducer`` names; empty strings disable caching.
+    std::string input_cache{};
+    std::string target_cache{};
+    /// Number of samples read ahead per source; zero reads synchronously.
+    std::size_t prefetch_depth{0};
+    CheckpointPolicy checkpoint{};
+    harmonics::FitOptions fit{default_fit_options()};
+    std::size_t steps{0};
+    /// Receives the step index and gradient norm after every update.
+    std::function<void(const TrainingMetrics&)> metrics{};
+    /// Data-parallel replicas per step. Each replica consumes one sample and
+    /// results depend only on this value, never on ``threads``.
+    std::size_t replicas{1};
+    /// Worker threads running replica forward passes; zero uses all cores.
+    unsigned threads{0};
+    /// Train with ``fit_until`` and ``make_auto_policy()`` instead of the
+    /// explicit update loop. The runtime then owns the weights and chooses
+    /// the execution policy; checkpoints and replicas are not supported and
+    /// ``timings().update`` stays zero because updates happen inside
+    /// ``fit_until``.
+    bool auto_policy{false};
+};
+
+/**
+ * @brief Average per-replica gradients into ``grads[0]`` in a fixed order.
+ *
+ * Gradients are summed pairwise along a binary tree over replica indices
+ * (0+1, 2+3, then (0+1)+(2+3), ...) and divided by the replica count. Float
+ * addition is not associative, so fixing the tree keeps the result
+ * bit-identical for any pool size; workers only split the tensors between
+ * them. Tensors hold float32 values; entries with an empty shape are skipped.
+ */
+inline void reduce_gradients(const std::vector<std::vector<harmonics::HTensor>*>& grads,
+                             WorkerPool& pool) {
+    const std::size_t n = grads.size();
+    if (n <= 1)
+        return;
+    const std::size_t count = grads[0]->size();
+    for (const auto* g : grads)
+        if (g->size() != count)
+            throw std::runtime_error("replica gradient count mismatch");
+    pool.parallel_for(count, [&](std::size_t j) {
+        auto& dst = (*grads[0])[j];
+        if (dst.shape().empty())
+            return;
+        const std::size_t bytes = dst.data().size();
+        for (const auto* g : grads)
+            if ((*g)[j].data().size() != bytes)
+                throw std::runtime_error("replica gradient shape mismatch");
+        const std::size_t elems = bytes / sizeof(float);
+        for (std::size_t stride = 1; stride < n; stride *= 2) {
+            for (std::size_t r = 0; r + stride < n; r += 2 * stride) {
+                float* a = reinterpret_cast<float*>((*grads[r])[j].data().data());
+                const float* b =
+                    reinterpret_cast<const float*>((*grads[r + stride])[j].data().data());
+                for (std::size_t e = 0; e < elems; ++e)
+                    a[e] += b[e];
+            }
+        }
+        float* out = reinterpret_cast<float*>(dst.data().data());
+        const float scale = static_cast<float>(n);
+        for (std::size_t e = 0; e < elems; ++e)
+            out[e] /= scale;
+    });
+}
+
+/** Convenience overload running the reduction on a temporary ``threads`` pool. */
+inline void reduce_gradients(const std::vector<std::vector<harmonics::HTensor>*>& grads,
+                             unsigned threads = 0) {
+    std::size_t count = grads.size() > 1 ? grads[0]->size() : 1;
+    WorkerPool pool(static_cast<unsigned>(
+        std::max<std::size_t>(1, std::min<std::size_t>(resolve_thread_count(threads), count))));
+    reduce_gradients(grads, pool);
+}
+
+/**
+ * @brief Single training engine behind every pipeline helper.
+ *
+ * Sources are optionally wrapped in ``DiskCacheProducer`` and
+ * ``PrefetchProducer`` before being bound to the default graph. Each step runs
+ * the forward pass, applies the configured optimizer, and reports metrics.
+ * Time spent in every stage is accumulated in ``timings()``; I/O is measured
+ * as time the runtime spends blocked inside producer ``next()`` calls.
+ *
+ * With ``replicas > 1`` every step deals one sample per replica in source
+ * order, runs the replica forward passes on ``threads`` workers and averages
+ * their gradients with ``reduce_gradients`` before a single optimizer update.
+ * The workers form one ``WorkerPool`` kept for the whole run, so steps do not
+ * pay for starting threads.
+ *
+ * With ``auto_policy`` the graph is trained by ``fit_until`` instead, exactly
+ * as the helpers in ``training.hpp`` always have.
+ */
+class TrainingPipeline {
+  public:
+    explicit TrainingPipeline(TrainingPipelineConfig cfg) : cfg_{std::move(cfg)} {}
+
+    /** Run ``steps`` training iterations and return the final global step. */
+    std::size_t run() {
+        using namespace harmonics;
+        register_training_shaders();
+        timings_ = {};
+        io_ns_ = 0;
+        params_.clear();
+
+        auto t0 = Clock::now();
+        auto src = make_source(cfg_.input, cfg_.input_cache);
+        std::shared_ptr<Producer> lbl =
+            cfg_.target ? make_source(cfg_.target, cfg_.target_cache)
+                        : std::make_shared<ConstantProducer>(0.0f, src->size());
+        timings_.io += seconds_since(t0);
+
+        if (cfg_.auto_policy)
+            return run_fit_until(src, lbl);
+
+        std::unique_lock<std::mutex> setup(training_setup_mutex());
+        Parser parser{default_training_graph()};
+        auto ast = parser.parse_declarations();
+        using Graph = decltype(build_graph(ast));
+        const std::size_t replicas = cfg_.replicas ? cfg_.replicas : 1;
+        std::vector<std::unique_ptr<Graph>> graphs;
+        std::vector<std::unique_ptr<CycleRuntime>> runtimes;
+        std::vector<std::shared_ptr<SlotProducer>> in_slots;
+        std::vector<std::shared_ptr<SlotProducer>> lbl_slots;
+        for (std::size_t r = 0; r < replicas; ++r) {
+            graphs.push_back(std::make_unique<Graph>(build_graph(ast)));
+            if (replicas == 1) {
+                graphs[r]->bindProducer("input", src);
+                graphs[r]->bindProducer("target", lbl);
+            } else {
+                in_slots.push_back(std::make_shared<SlotProducer>(src->size()));
+                lbl_slots.push_back(std::make_shared<SlotProducer>(lbl->size()));
+                graphs[r]->bindProducer("input", in_slots[r]);
+                graphs[r]->bindProducer("target", lbl_slots[r]);
+            }
+            runtimes.push_back(std::make_unique<CycleRuntime>(*graphs[r]));
+        }
+        setup.unlock();
+        WorkerPool pool(replicas > 1 ? cfg_.threads : 1);
+        CycleRuntime& rt = *runtimes[0];
+        const std::size_t count = rt.state().weights.size();
+        std::vector<TensorPtr> params(count);
+        std::vector<TensorPtr> opt1(count);
+        std::vector<TensorPtr> opt2(count);
+        for (std::size_t j = 0; j < count; ++j) {
+            params[j] = std::make_shared<HTensor>();
+            opt1[j] = std::make_shared<HTensor>();
+            opt2[j] = std::make_shared<HTensor>();
+        }
+        t0 = Clock::now();
+        std::size_t start_step = load_checkpoint(rt, params, opt1, opt2);
+        for (std::size_t r = 1; r < replicas; ++r)
+            runtimes[r]->state().weights = rt.state().weights;
+        timings_.checkpoint += seconds_since(t0);
+
+        std::unique_ptr<CheckpointWriter> writer;
+        if (!cfg_.checkpoint.path.empty() && cfg_.checkpoint.async)
+            writer = std::make_unique<CheckpointWriter>(cfg_.checkpoint.path);
+        auto checkpoint = [&](std::size_t step) {
+            TrainingSnapshot snap{step,
+                                  {params.begin(), params.end()},
+                                  {opt1.begin(), opt1.end()},
+                                  {opt2.begin(), opt2.end()}};
+            if (writer)
+                writer->submit(std::move(snap));
+            else
+                save_training_snapshot(snap, cfg_.checkpoint.path);
+        };
+
+        const FitOptions& opt = cfg_.fit;
+        TrainingMetrics m{};
+        for (std::size_t i = 0; i < cfg_.steps; ++i) {
+            std::int64_t io_before = io_ns_.load(std::memory_order_relaxed);
+            t0 = Clock::now();
+            // Shard r of every step is the same sample regardless of how many
+            // threads run the replicas.
+            for (std::size_t r = 0; r < in_slots.size(); ++r) {
+                in_slots[r]->set(src->next());
+                lbl_slots[r]->set(lbl->next());
+            }
+            pool.parallel_for(replicas, [&](std::size_t r) { runtimes[r]->forward(); });
+            double io = static_cast<double>(io_ns_.load(std::memory_order_relaxed) - io_before) *
+                        1e-9;
+            timings_.forward += seconds_since(t0) - io;
+            timings_.io += io;
+
+            t0 = Clock::now();
+            // Tensors still referenced by a snapshot being written are cloned
+            // before the update so the writer sees a consistent state.
+            if (writer && writer->in_flight()) {
+                for (auto* vec : {&params, &opt1, &opt2})
+                    for (auto& p : *vec)
+                        if (p.use_count() > 1)
+                            p = std::make_shared<HTensor>(*p);
+            }
+            if (replicas > 1) {
+                std::vector<std::vector<HTensor>*> grads(replicas);
+                for (std::size_t r = 0; r < replicas; ++r)
+                    grads[r] = &runtimes[r]->state().weights;
+                reduce_gradients(grads, pool);
+            }
+            float norm = gradients_l2_norm(rt.state().weights);
+            for (std::size_t j = 0; j < count; ++j) {
+                if (!rt.state().weights[j].shape().empty()) {
+                    clip_tensor(rt.state().weights[j], opt.grad_clip);
+                    switch (opt.optimizer) {
+                    case Optimizer::SGD:
+                        apply_sgd_update(*params[j], rt.state().weights[j], opt.learning_rate);
+                        break;
+                    case Optimizer::Adam:
+                        apply_adam_update(*params[j], rt.state().weights[j], *opt1[j], *opt2[j],
+                                          start_step + i + 1, opt.learning_rate);
+                        break;
+                    case Optimizer::RMSProp:
+                        apply_rmsprop_update(*params[j], rt.state().weights[j], *opt1[j],
+                                             opt.learning_rate);
+                        break;
+                    }
+                }
+            }
+            timings_.update += seconds_since(t0);
+
+            t0 = Clock::now();
+            m.step = static_cast<std::uint32_t>(start_step + i + 1);
+            m.loss = norm;
+            if (cfg_.metrics)
+                cfg_.metrics(m);
+            timings_.metrics += seconds_since(t0);
+
+            std::size_t global = start_step + i + 1;
+            if (!cfg_.checkpoint.path.empty() && cfg_.checkpoint.interval &&
+                global % cfg_.checkpoint.interval == 0 && i + 1 < cfg_.steps) {
+                t0 = Clock::now();
+                checkpoint(global);
+                timings_.checkpoint += seconds_since(t0);
+            }
+            ++timings_.steps;
+        }
+
+        std::size_t total = start_step + cfg_.steps;
+        t0 = Clock::now();
+        if (!cfg_.checkpoint.path.empty()) {
+            checkpoint(total);
+            if (writer)
+                writer->flush();
+        }
+        timings_.checkpoint += seconds_since(t0);
+        params_.reserve(count);
+        for (const auto& p : params)
+            params_.push_back(*p);
+        return total;
+    }
+
+    /** Stage timings collected by the most recent ``run``. */
+    const PipelineTimings& timings() const { return timings_; }
+
+    /**
+     * Parameters trained by the most recent ``run``. Empty after
+     * ``auto_policy`` runs, whose weights stay inside the runtime.
+     */
+    const std::vector<harmonics::HTensor>& parameters() const { return params_; }
+
+    const TrainingPipelineConfig& config() const { return cfg_; }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    using TensorPtr = std::shared_ptr<harmonics::HTensor>;
+
+    static double seconds_since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::size_t run_fit_until(std::shared_ptr<harmonics::Producer> src,
+                              std::shared_ptr<harmonics::Producer> lbl) {
+        using namespace harmonics;
+        if (!cfg_.checkpoint.path.empty() || cfg_.replicas > 1)
+            throw std::runtime_error("auto policy training supports neither checkpoints nor "
+                                     "replicas");
+        std::unique_lock<std::mutex> setup(training_setup_mutex());
+        Parser parser{default_training_graph()};
+        auto ast = parser.parse_declarations();
+        auto g = build_graph(ast);
+        g.bindProducer("input", src);
+        g.bindProducer("target", lbl);
+        setup.unlock();
+
+        TrainingMetrics m{};
+        std::size_t step = 0;
+        double metrics = 0.0;
+        auto stop = [&](const CycleState& state) {
+            auto t = Clock::now();
+            float norm = gradients_l2_norm(state.weights);
+            ++step;
+            m.step = static_cast<std::uint32_t>(step);
+            m.loss = norm;
+            if (cfg_.metrics)
+                cfg_.metrics(m);
+            metrics += seconds_since(t);
+            ++timings_.steps;
+            return step >= cfg_.steps;
+        };
+        auto t0 = Clock::now();
+        g.fit_until(stop, make_auto_policy(), cfg_.fit);
+        double io = static_cast<double>(io_ns_.load(std::memory_order_relaxed)) * 1e-9;
+        timings_.io += io;
+        timings_.metrics += metrics;
+        timings_.forward += seconds_since(t0) - io - metrics;
+        return step;
+    }
+
+    /** Hands the sample dealt to one replica to its runtime. */
+    struct SlotProducer : harmonics::Producer {
+        explicit SlotProducer(std::size_t n) : n_{n} {}
+        void set(harmonics::HTensor t) { sample = std::move(t); }
+        harmonics::HTensor next() override { return sample; }
+        std::size_t size() const override { return n_; }
+        harmonics::HTensor sample{};
+        std::size_t n_{0};
+    };
+
+    /** Accumulates time spent blocked in the wrapped producer. */
+    struct TimedProducer : harmonics::Producer {
+        TimedProducer(std::shared_ptr<harmonics::Producer> b, std::atomic<std::int64_t>& ns)
+            : base{std::move(b)}, io_ns{ns} {}
+        harmonics::HTensor next() override {
+            auto t0 = Clock::now();
+            harmonics::HTensor t = base->next();
+            io_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0)
+                         .count();
+            return t;
+        }
+        std::size_t size() const override { return base->size(); }
+        std::shared_ptr<harmonics::Producer> base;
+        std::atomic<std::int64_t>& io_ns;
+    };
+
+    std::shared_ptr<harmonics::Producer> make_source(std::shared_ptr<harmonics::Producer> base,
+                                                     const std::string& cache_name) {
+        std::shared_ptr<harmonics::Producer> src = std::move(base);
+#if __has_include(<harmonics/disk_cache_producer.hpp>)
+        if (!cache_name.empty())
+            src = std::make_shared<harmonics::DiskCacheProducer>(src, cache_name);
+#else
+        (void)cache_name;
+#endif
+        if (cfg_.prefetch_depth > 0)
+            src = std::make_shared<PrefetchProducer>(src, cfg_.prefetch_depth);
+        return std::make_shared<TimedProducer>(src, io_ns_);
+    }
+
+    /**
+     * Restore parameters, optimizer moments and the global step. Checkpoints
+     * written before optimizer state was persisted are still accepted; their
+     * moments start from zero.
+     */
+    std::size_t load_checkpoint(harmonics::CycleRuntime& rt, std::vector<TensorPtr>& params,
+                                std::vector<TensorPtr>& opt1, std::vector<TensorPtr>& opt2) {
+        if (cfg_.checkpoint.path.empty() || !cfg_.checkpoint.resume)
+            return 0;
+        if (is_training_checkpoint(cfg_.checkpoint.path)) {
+            TrainingState st = load_training_state(cfg_.checkpoint.path);
+            if (st.params.size() != params.size())
+                throw std::runtime_error("checkpoint does not match graph");
+            for (std::size_t j = 0; j < params.size(); ++j) {
+                params[j] = std::make_shared<harmonics::HTensor>(std::move(st.params[j]));
+                opt1[j] = std::make_shared<harmonics::HTensor>(std::move(st.opt1[j]));
+                opt2[j] = std::make_shared<harmonics::HTensor>(std::move(st.opt2[j]));
+                rt.state().weights[j] = *params[j];
+            }
+            return static_cast<std::size_t>(st.step);
+        }
+        std::size_t start_step = 0;
+#if __has_include(<harmonics/disk_cache_producer.hpp>)
+        std::ifstream in(cfg_.checkpoint.path, std::ios::binary);
+        if (in) {
+            rt.load_checkpoint(in);
+            in.read(reinterpret_cast<char*>(&start_step), sizeof(start_step));
+        }
+#else
+        (void)rt;
+#endif
+        return start_step;
+    }
+
+    TrainingPipelineConfig cfg_{};
+    PipelineTimings timings_{};
+    std::vector<harmonics::HTensor> params_{};
+    std::atomic<std::int64_t> io_ns_{0};
+};
+
+} // namespace neuropet
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "neuropet/traits.hpp"
+
+namespace neuropet {
+
+/** One column per 4-bit component of a body, sensor or appendage slot. */
+struct TraitPartColumns {
+    std::vector<std::uint8_t> shape{};
+    std::vector<std::uint8_t> hue{};
+    std::vector<std::uint8_t> saturation{};
+    std::vector<std::uint8_t> value{};
+
+    void resize(std::size_t n) {
+        shape.resize(n);
+        hue.resize(n);
+        saturation.resize(n);
+        value.resize(n);
+    }
+};
+
+/**
+ * @brief Structure-of-arrays view of many ``VisualTraits``.
+ *
+ * Every field lives in its own contiguous column so bulk codecs and filters
+ * stream through exactly the bytes they need. Inactive sensor and appendage
+ * slots hold zeros.
+ */
+struct TraitColumns {
+    TraitPartColumns body{};
+    std::array<TraitPartColumns, MAX_SENSORS> sensor{};
+    std::array<TraitPartColumns, MAX_APPENDAGES> appendage{};
+    std::vector<std::uint8_t> sensor_count{};
+    std::vector<std::uint8_t> appendage_count{};
+
+    std::size_t size() const { return sensor_count.size(); }
+
+    void resize(std::size_t n) {
+        body.resize(n);
+        for (auto& p : sensor)
+            p.resize(n);
+        for (auto& p : appendage)
+            p.resize(n);
+        sensor_count.resize(n);
+        appendage_count.resize(n);
+    }
+
+    void push_back(const VisualTraits& t) {
+        const std::size_t i = size();
+        resize(i + 1);
+        set(i, t);
+    }
+
+    void set(std::size_t i, const VisualTraits& t) {
+        const unsigned sc = std::min<unsigned>(t.sensor_count, MAX_SENSORS);
+        const unsigned ac = std::min<unsigned>(t.appendage_count, MAX_APPENDAGES);
+        put(body, i, t.body_shape, t.body_colour);
+        for (unsigned k = 0; k < MAX_SENSORS; ++k)
+            put(sensor[k], i, k < sc ? t.sensor_shape[k] : 0, k < sc ? t.sensor_colour[k] : HSV{});
+        for (unsigned k = 0; k < MAX_APPENDAGES; ++k)
+            put(appendage[k], i, k < ac ? t.appendage_shape[k] : 0,
+                k < ac ? t.appendage_colour[k] : HSV{});
+        sensor_count[i] = static_cast<std::uint8_t>(sc);
+        appendage_count[i] = static_cast<std::uint8_t>(ac);
+    }
+
+    VisualTraits at(std::size_t i) const {
+        VisualTraits t{};
+        t.sensor_count = sensor_count[i];
+        t.appendage_count = appendage_count[i];
+        t.body_shape = body.shape[i];
+        t.body_colour = colour(body, i);
+        for (unsigned k = 0; k < MAX_SENSORS; ++k) {
+            t.sensor_shape[k] = sensor[k].shape[i];
+            t.sensor_colour[k] = colour(sensor[k], i);
+        }
+        for (unsigned k = 0; k < MAX_APPENDAGES; ++k) {
+            t.appendage_shape[k] = appendage[k].shape[i];
+            t.appendage_colour[k] = colour(appendage[k], i);
+        }
+        return t;
+    }
+
+  private:
+    static void put(TraitPartColumns& p, std::size_t i, std::uint8_t shape, const HSV& c) {
+        p.shape[i] = shape & 0xF;
+        p.hue[i] = c.h & 0xF;
+        p.saturation[i] = c.s & 0xF;
+        p.value[i] = c.v & 0xF;
+    }
+
+    static HSV colour(const TraitPartColumns& p, std::size_t i) {
+        return {p.hue[i], p.saturation[i], p.value[i]};
+    }
+};
+
+namespace detail {
+
+/** Low ``16 * k`` bits set, for ``k`` in ``[0, 4]``. */
+inline std::uint64_t slot_mask(unsigned k) {
+    static constexpr std::uint64_t table[5] = {0, 0xFFFFull, 0xFFFFFFFFull, 0xFFFFFFFFFFFFull,
+                                               ~0ull};
+    return table[k];
+}
+
+/** Rows handled per pass so the scratch words stay in L1. */
+constexpr std::size_t kTraitBlock = 512;
+
+/**
+ * OR the 16-bit ``pack_traits`` slot (shape, then value, saturation and hue
+ * nibbles) of rows ``[first, first + n)`` into ``words`` at bit ``shift``.
+ */
+inline void gather_slots(const TraitPartColumns& p, std::size_t first, std::size_t n,
+                         unsigned shift, std::uint64_t* words) {
+    const std::uint8_t* sh = p.shape.data() + first;
+    const std::uint8_t* h = p.hue.data() + first;
+    const std::uint8_t* s = p.saturation.data() + first;
+    const std::uint8_t* v = p.value.data() + first;
+    for (std::size_t i = 0; i < n; ++i)
+        words[i] |= (static_cast<std::uint64_t>(sh[i]) | (static_cast<std::uint64_t>(v[i]) << 4) |
+                     (static_cast<std::uint64_t>(s[i]) << 8) |
+                     (static_cast<std::uint64_t>(h[i]) << 12))
+                    << shift;
+}
+
+/** Inverse of ``gather_slots``. */
+inline void scatter_slots(TraitPartColumns& p, std::size_t first, std::size_t n, unsigned shift,
+                          const std::uint64_t* words) {
+    std::uint8_t* sh = p.shape.data() + first;
+    std::uint8_t* h = p.hue.data() + first;
+    std::uint8_t* s = p.saturation.data() + first;
+    std::uint8_t* v = p.value.data() + first;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t w = words[i] >> shift;
+        sh[i] = static_cast<std::uint8_t>(w & 0xF);
+        v[i] = static_cast<std::uint8_t>((w >> 4) & 0xF);
+        s[i] = static_cast<std::uint8_t>((w >> 8) & 0xF);
+        h[i] = static_cast<std::uint8_t>((w >> 12) & 0xF);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Pack every row of ``cols`` into ``out`` with ``pack_traits`` layout.
+ *
+ * Rows are processed in blocks. Within a block each column is streamed once
+ * to assemble the four sensor slots and the four appendage slots into one
+ * 64-bit word per row; these loops are branch-free shifts and ORs over
+ * contiguous bytes that compilers vectorize. A final pass masks each word
+ * to the active slot count and shifts it into place. Slots that would start
+ * beyond bit 128 are dropped.
+ */
+inline void pack_traits_bulk(const TraitColumns& cols, unsigned __int128* out) {
+    const std::size_t n = cols.size();
+    std::uint64_t body[detail::kTraitBlock];
+    std::uint64_t sens[detail::kTraitBlock];
+    std::uint64_t apps[detail::kTraitBlock];
+    for (std::size_t first = 0; first < n; first += detail::kTraitBlock) {
+        const std::size_t m = std::min(detail::kTraitBlock, n - first);
+        std::fill(body, body + m, 0);
+        std::fill(sens, sens + m, 0);
+        std::fill(apps, apps + m, 0);
+        detail::gather_slots(cols.body, first, m, 0, body);
+        for (unsigned k = 0; k < MAX_SENSORS; ++k)
+            detail::gather_slots(cols.sensor[k], first, m, 16 * k, sens);
+        for (unsigned k = 0; k < MAX_APPENDAGES; ++k)
+            detail::gather_slots(cols.appendage[k], first, m, 16 * k, apps);
+        for (std::size_t i = 0; i < m; ++i) {
+            const unsigned sc = std::min<unsigned>(cols.sensor_count[first + i], MAX_SENSORS);
+            const unsigned ac = std::min<unsigned>(cols.appendage_count[first + i], MAX_APPENDAGES);
+            out[first + i] =
+                static_cast<unsigned __int128>(body[i]) |
+                (static_cast<unsigned __int128>(sens[i] & detail::slot_mask(sc)) << 16) |
+                (static_cast<unsigned __int128>(apps[i] & detail::slot_mask(ac)) << (16 * (1 + sc)));
+        }
+    }
+}
+
+inline std::vector<unsigned __int128> pack_traits_bulk(const TraitColumns& cols) {
+    std::vector<unsigned __int128> out(cols.size());
+    pack_traits_bulk(cols, out.data());
+    return out;
+}
+
+/**
+ * Inverse of ``pack_traits_bulk``: row ``i`` equals
+ * ``unpack_traits(packed[i], sensors[i], appendages[i])``.
+ */
+inline TraitColumns unpack_traits_bulk(const unsigned __int128* packed,
+                                       const std::uint8_t* sensors,
+                                       const std::uint8_t* appendages, std::size_t n) {
+    TraitColumns cols;
+    cols.resize(n);
+    std::copy(sensors, sensors + n, cols.sensor_count.begin());
+    std::copy(appendages, appendages + n, cols.appendage_count.begin());
+    std::uint64_t body[detail::kTraitBlock];
+    std::uint64_t sens[detail::kTraitBlock];
+    std::uint64_t apps[detail::kTraitBlock];
+    for (std::size_t first = 0; first < n; first += detail::kTraitBlock) {
+        const std::size_t m = std::min(detail::kTraitBlock, n - first);
+        for (std::size_t i = 0; i < m; ++i) {
+            const unsigned sc = std::min<unsigned>(sensors[first + i], MAX_SENSORS);
+            const unsigned ac = std::min<unsigned>(appendages[first + i], MAX_APPENDAGES);
+            const unsigned __int128 p = packed[first + i];
+            body[i] = static_cast<std::uint64_t>(p) & 0xFFFF;
+            sens[i] = static_cast<std::uint64_t>(p >> 16) & detail::slot_mask(sc);
+            apps[i] = static_cast<std::uint64_t>(p >> (16 * (1 + sc))) & detail::slot_mask(ac);
+        }
+        detail::scatter_slots(cols.body, first, m, 0, body);
+        for (unsigned k = 0; k < MAX_SENSORS; ++k)
+            detail::scatter_slots(cols.sensor[k], first, m, 16 * k, sens);
+        for (unsigned k = 0; k < MAX_APPENDAGES; ++k)
+            detail::scatter_slots(cols.appendage[k], first, m, 16 * k, apps);
+    }
+    return cols;
+}
+
+/** Fields indexed by ``TraitIndex``. Sensor and appendage fields match any active slot. */
+enum class TraitField : std::uint8_t {
+    BodyShape,
+    BodyHue,
+    BodySaturation,
+    BodyValue,
+    SensorShape,
+    SensorHue,
+    SensorSaturation,
+    SensorValue,
+    AppendageShape,
+    AppendageHue,
+    AppendageSaturation,
+    AppendageValue,
+    SensorCount,
+    AppendageCount,
+};
+
+constexpr std::size_t kTraitFieldCount = 14;
+
+/** Row set over a ``TraitColumns`` table, one bit per creature. */
+struct TraitBitmap {
+    std::vector<std::uint64_t> words{};
+    std::size_t size{0};
+
+    explicit TraitBitmap(std::size_t n = 0) : words((n + 63) / 64, 0), size{n} {}
+
+    void set(std::size_t i) { words[i >> 6] |= std::uint64_t{1} << (i & 63); }
+    bool test(std::size_t i) const { return (words[i >> 6] >> (i & 63)) & 1u; }
+
+    TraitBitmap& operator&=(const TraitBitmap& o) {
+        for (std::size_t w = 0; w < words.size(); ++w)
+            words[w] &= o.words[w];
+        return *this;
+    }
+
+    TraitBitmap& operator|=(const TraitBitmap& o) {
+        for (std::size_t w = 0; w < words.size(); ++w)
+            words[w] |= o.words[w];
+        return *this;
+    }
+
+    std::size_t count() const {
+        std::size_t c = 0;
+        for (std::uint64_t w : words)
+            c += static_cast<std::size_t>(__builtin_popcountll(w));
+        return c;
+    }
+
+    /** Row numbers of the set bits in ascending order. */
+    std::vector<std::size_t> rows() const {
+        std::vector<std::size_t> out;
+        for (std::size_t w = 0; w < words.size(); ++w)
+            for (std::uint64_t bits = words[w]; bits; bits &= bits - 1)
+                out.push_back(w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits)));
+        return out;
+    }
+};
+
+/** Equality filter for ``TraitIndex::select``. */
+struct TraitFilter {
+    TraitField field{TraitField::BodyShape};
+    std::uint8_t value{0};
+};
+
+/**
+ * @brief Bitmap index over every 4-bit trait value.
+ *
+ * Holds one ``TraitBitmap`` per field and value, built in a single pass over
+ * the columns. A query ANDs or ORs the relevant bitmaps word by word, so
+ * filtering a million creatures touches a few hundred kilobytes and never
+ * decodes a packed trait.
+ */
+class TraitIndex {
+  public:
+    explicit TraitIndex(const TraitColumns& cols) : size_{cols.size()} {
+        maps_.assign(kTraitFieldCount * 16, TraitBitmap(size_));
+        for (std::size_t i = 0; i < size_; ++i) {
+            mark(TraitField::BodyShape, cols.body, i);
+            const unsigned sc = std::min<unsigned>(cols.sensor_count[i], MAX_SENSORS);
+            const unsigned ac = std::min<unsigned>(cols.appendage_count[i], MAX_APPENDAGES);
+            for (unsigned k = 0; k < sc; ++k)
+                mark(TraitField::SensorShape, cols.sensor[k], i);
+            for (unsigned k = 0; k < ac; ++k)
+                mark(TraitField::AppendageShape, cols.appendage[k], i);
+            slot(TraitField::SensorCount, cols.sensor_count[i]).set(i);
+            slot(TraitField::AppendageCount, cols.appendage_count[i]).set(i);
+        }
+    }
+
+    std::size_t size() const { return size_; }
+
+    /** Rows whose ``field`` equals ``value``. */
+    const TraitBitmap& bitmap(TraitField field, std::uint8_t value) const {
+        if (value > 0xF)
+            throw std::runtime_error("trait value out of range");
+        return maps_[static_cast<std::size_t>(field) * 16 + value];
+    }
+
+    /** Rows matching every filter; no filters selects all rows. */
+    TraitBitmap select(const std::vector<TraitFilter>& filters) const {
+        if (filters.empty()) {
+            TraitBitmap all(size_);
+            for (std::size_t i = 0; i < size_; ++i)
+                all.set(i);
+            return all;
+        }
+        TraitBitmap out = bitmap(filters[0].field, filters[0].value);
+        for (std::size_t f = 1; f < filters.size(); ++f)
+            out &= bitmap(filters[f].field, filters[f].value);
+        return out;
+    }
+
+  private:
+    TraitBitmap& slot(TraitField field, std::uint8_t value) {
+        return maps_[static_cast<std::size_t>(field) * 16 + (value & 0xF)];
+    }
+
+    /** Set ``i`` in the shape, hue, saturation and value maps starting at ``first``. */
+    void mark(TraitField first, const TraitPartColumns& p, std::size_t i) {
+        const auto f = static_cast<std::uint8_t>(first);
+        slot(first, p.shape[i]).set(i);
+        slot(static_cast<TraitField>(f + 1), p.hue[i]).set(i);
+        slot(static_cast<TraitField>(f + 2), p.saturation[i]).set(i);
+        slot(static_cast<TraitField>(f + 3), p.value[i]).set(i);
+    }
+
+    std::size_t size_{0};
+    std::vector<TraitBitmap> maps_{};
+};
+
+} // namespace neuropet
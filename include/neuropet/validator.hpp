@@ -21,7 +21,7 @@ class Validator {
                        ProofAggregatorServer* p2p = nullptr)
         : quorum_(quorum), proof_system_(system), p2p_(p2p) {
         if (p2p_)
-            p2p_->set_callback([this](const StarkProof& p) { attest(p.root); });
+            p2p_->set_callback([this](const StarkProof& p) { attest(p.root_digest()); });
     }
 
     /** Generate a proof digest from INT8 tensors. */
@@ -37,16 +37,30 @@ class Validator {
         return proof;
     }
 
+    /** Generate a STARK proof over views into caller-owned tensors and broadcast it. */
+    StarkProof generate_stark_proof(const TensorView* tensors, std::size_t count) const {
+        StarkProof proof = proof_system_.generate_proof(tensors, count);
+        if (p2p_)
+            p2p_->submit(proof);
+        return proof;
+    }
+
     /** Verify a STARK proof against tensors. */
     bool verify_stark_proof(const std::vector<std::vector<int8_t>>& tensors,
                             const StarkProof& proof) const {
-        if (!proof_system_.verify_proof(tensors, proof))
+        auto views = tensor_views(tensors);
+        return verify_stark_proof(views.data(), views.size(), proof);
+    }
+
+    bool verify_stark_proof(const TensorView* tensors, std::size_t count,
+                            const StarkProof& proof) const {
+        if (!proof_system_.verify_proof(tensors, count, proof))
             return false; // The proof itself was invalid.
 
         // Only accept a proof when the reported loss is not worse than
         // the previous accepted value. This enforces monotonic improvement
         // during a training session.
-        float loss = compute_loss(tensors);
+        float loss = compute_loss(tensors, count);
         if (last_loss_ < loss)
             return false;
         last_loss_ = loss;
@@ -99,19 +113,21 @@ class Validator {
     }
 
     /** Record an attestation for the given root hash. */
-    void attest(const std::string& root) { ++counts_[root]; }
+    void attest(const Digest32& root) { ++counts_[root]; }
+    void attest(const std::string& root) { attest(Digest32::from_root(root)); }
 
     /** Check if a root hash has reached quorum. */
-    bool has_quorum(const std::string& root) const {
+    bool has_quorum(const Digest32& root) const {
         auto it = counts_.find(root);
         return it != counts_.end() && it->second >= quorum_;
     }
+    bool has_quorum(const std::string& root) const { return has_quorum(Digest32::from_root(root)); }
 
   private:
     std::size_t quorum_;
     const IProofSystem& proof_system_;
     ProofAggregatorServer* p2p_{nullptr};
-    std::unordered_map<std::string, std::size_t> counts_{};
+    std::unordered_map<Digest32, std::size_t, Digest32Hash> counts_{};
     mutable float last_loss_{std::numeric_limits<float>::infinity()};
     std::unordered_map<std::uint64_t, std::vector<std::uint8_t>> curricula_{};
 };
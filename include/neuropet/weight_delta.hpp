@@ -0,0 +1,381 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if __has_include(<zstd.h>)
+#include <zstd.h>
+#define NEUROPET_HAS_ZSTD 1
+#else
+#define NEUROPET_HAS_ZSTD 0
+#endif
+
+#include "neuropet/int8_spec.hpp"
+
+namespace neuropet {
+
+/** Flat list of INT8 tensors making up a creature checkpoint. */
+using WeightTensors = std::vector<std::vector<int8_t>>;
+
+enum class WeightFrameKind : std::uint8_t { Keyframe = 0, Delta = 1 };
+enum class WeightCodec : std::uint8_t { Raw = 0, Zstd = 1 };
+
+/** Return ``[weights, bias]`` for every layer of ``net`` in order. */
+inline WeightTensors network_tensors(const Int8Network& net) {
+    WeightTensors out;
+    out.reserve(net.layers.size() * 2);
+    for (const auto& l : net.layers) {
+        out.push_back(l.weights);
+        out.push_back(l.bias);
+    }
+    return out;
+}
+
+/** Overwrite the layer weights of ``net`` with tensors from ``network_tensors``. */
+inline void assign_network_tensors(Int8Network& net, const WeightTensors& t) {
+    if (t.size() != net.layers.size() * 2)
+        throw std::runtime_error("tensor count does not match network");
+    for (std::size_t i = 0; i < net.layers.size(); ++i) {
+        net.layers[i].weights = t[2 * i];
+        net.layers[i].bias = t[2 * i + 1];
+    }
+}
+
+namespace detail {
+
+inline bool same_layout(const WeightTensors& a, const WeightTensors& b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        if (a[i].size() != b[i].size())
+            return false;
+    return true;
+}
+
+/** ``dst[i] ^= src[i]`` processed eight bytes at a time. */
+inline void xor_bytes(std::uint8_t* dst, const std::uint8_t* src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t a;
+        std::uint64_t b;
+        std::memcpy(&a, dst + i, 8);
+        std::memcpy(&b, src + i, 8);
+        a ^= b;
+        std::memcpy(dst + i, &a, 8);
+    }
+    for (; i < n; ++i)
+        dst[i] ^= src[i];
+}
+
+inline void put_u32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+inline void put_u64(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i)
+        out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+inline std::uint64_t get_le(const std::uint8_t*& p, const std::uint8_t* end, int bytes) {
+    if (end - p < bytes)
+        throw std::runtime_error("truncated weight frame");
+    std::uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i)
+        v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    p += bytes;
+    return v;
+}
+
+#if NEUROPET_HAS_ZSTD
+/**
+ * Decompress one zstd frame that must produce exactly ``expected`` bytes.
+ * The output buffer grows geometrically with the data actually produced, so
+ * a forged size in a frame header cannot trigger a huge allocation.
+ */
+inline void zstd_decompress(const std::uint8_t* src, std::size_t size, std::uint64_t expected,
+                            std::vector<std::uint8_t>& out) {
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+    if (!ctx)
+        throw std::runtime_error("zstd decompression failed");
+    out.resize(static_cast<std::size_t>(
+        std::min<std::uint64_t>(expected, std::uint64_t{ZSTD_DStreamOutSize()})));
+    ZSTD_inBuffer in{src, size, 0};
+    ZSTD_outBuffer dst{out.data(), out.size(), 0};
+    for (;;) {
+        if (dst.pos == dst.size && dst.size < expected) {
+            out.resize(static_cast<std::size_t>(
+                std::min<std::uint64_t>(expected, std::uint64_t{out.size()} * 2)));
+            dst.dst = out.data();
+            dst.size = out.size();
+        }
+        std::size_t in_before = in.pos;
+        std::size_t out_before = dst.pos;
+        std::size_t r = ZSTD_decompressStream(ctx.get(), &dst, &in);
+        if (ZSTD_isError(r))
+            throw std::runtime_error("zstd decompression failed");
+        if (r == 0)
+            break;
+        if (in.pos == in_before && dst.pos == out_before)
+            throw std::runtime_error("zstd decompression failed");
+    }
+    if (dst.pos != expected)
+        throw std::runtime_error("zstd decompression failed");
+}
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Encode a checkpoint relative to ``base``.
+ *
+ * When ``base`` is null or its tensor layout differs, a keyframe holding the
+ * raw weights is produced. Otherwise the frame stores the XOR of both
+ * checkpoints; weights that did not change between epochs become zero bytes,
+ * which zstd compresses to almost nothing.
+ *
+ * Layout: ``NPWD`` magic, u32 version, u8 kind, u8 codec, u32 epoch,
+ * u32 tensor count, u32 size per tensor, u64 raw payload size, u64 stored
+ * payload size, payload.
+ */
+inline std::vector<std::uint8_t> encode_weight_frame(const WeightTensors* base,
+                                                     const WeightTensors& cur,
+                                                     std::uint32_t epoch, int level = 3) {
+    bool delta = base && detail::same_layout(*base, cur);
+    std::vector<std::uint8_t> raw;
+    std::size_t total = 0;
+    for (const auto& t : cur)
+        total += t.size();
+    raw.reserve(total);
+    for (std::size_t i = 0; i < cur.size(); ++i) {
+        std::size_t off = raw.size();
+        raw.insert(raw.end(), cur[i].begin(), cur[i].end());
+        if (delta && !cur[i].empty())
+            detail::xor_bytes(raw.data() + off,
+                              reinterpret_cast<const std::uint8_t*>((*base)[i].data()),
+                              cur[i].size());
+    }
+
+    std::vector<std::uint8_t> out{'N', 'P', 'W', 'D'};
+    detail::put_u32(out, 1); // version
+    out.push_back(static_cast<std::uint8_t>(delta ? WeightFrameKind::Delta
+                                                  : WeightFrameKind::Keyframe));
+#if NEUROPET_HAS_ZSTD
+    out.push_back(static_cast<std::uint8_t>(WeightCodec::Zstd));
+#else
+    (void)level;
+    out.push_back(static_cast<std::uint8_t>(WeightCodec::Raw));
+#endif
+    detail::put_u32(out, epoch);
+    detail::put_u32(out, static_cast<std::uint32_t>(cur.size()));
+    for (const auto& t : cur)
+        detail::put_u32(out, static_cast<std::uint32_t>(t.size()));
+    detail::put_u64(out, raw.size());
+#if NEUROPET_HAS_ZSTD
+    std::vector<std::uint8_t> packed(ZSTD_compressBound(raw.size()));
+    std::size_t n = ZSTD_compress(packed.data(), packed.size(), raw.data(), raw.size(), level);
+    if (ZSTD_isError(n))
+        throw std::runtime_error("zstd compression failed");
+    packed.resize(n);
+#else
+    std::vector<std::uint8_t>& packed = raw;
+#endif
+    detail::put_u64(out, packed.size());
+    out.insert(out.end(), packed.begin(), packed.end());
+    return out;
+}
+
+/** Header fields of an encoded weight frame. */
+struct WeightFrameInfo {
+    WeightFrameKind kind{WeightFrameKind::Keyframe};
+    std::uint32_t epoch{0};
+};
+
+/**
+ * @brief Reconstruct the checkpoint stored in ``frame``.
+ *
+ * Delta frames require the checkpoint they were encoded against as ``base``;
+ * keyframes ignore it.
+ */
+inline WeightTensors apply_weight_frame(const WeightTensors* base,
+                                        const std::vector<std::uint8_t>& frame,
+                                        WeightFrameInfo* info = nullptr) {
+    const std::uint8_t* p = frame.data();
+    const std::uint8_t* end = p + frame.size();
+    if (frame.size() < 4 || std::memcmp(p, "NPWD", 4) != 0)
+        throw std::runtime_error("invalid weight frame");
+    p += 4;
+    if (detail::get_le(p, end, 4) != 1)
+        throw std::runtime_error("unsupported weight frame version");
+    auto kind = static_cast<WeightFrameKind>(detail::get_le(p, end, 1));
+    if (kind != WeightFrameKind::Keyframe && kind != WeightFrameKind::Delta)
+        throw std::runtime_error("unknown weight frame kind");
+    auto codec = static_cast<WeightCodec>(detail::get_le(p, end, 1));
+    if (codec != WeightCodec::Raw && codec != WeightCodec::Zstd)
+        throw std::runtime_error("unknown weight frame codec");
+    std::uint32_t epoch = static_cast<std::uint32_t>(detail::get_le(p, end, 4));
+    std::uint32_t count = static_cast<std::uint32_t>(detail::get_le(p, end, 4));
+    // Header fields are untrusted: nothing is allocated before it is known to
+    // fit in the frame or, for compressed payloads, actually decompressed.
+    if (static_cast<std::uint64_t>(count) * 4 > static_cast<std::uint64_t>(end - p))
+        throw std::runtime_error("truncated weight frame");
+    std::vector<std::uint32_t> sizes(count);
+    std::uint64_t total = 0;
+    for (auto& s : sizes) {
+        s = static_cast<std::uint32_t>(detail::get_le(p, end, 4));
+        total += s;
+    }
+    std::uint64_t raw_size = detail::get_le(p, end, 8);
+    std::uint64_t stored = detail::get_le(p, end, 8);
+    if (raw_size != total)
+        throw std::runtime_error("corrupt weight frame");
+    if (static_cast<std::uint64_t>(end - p) < stored)
+        throw std::runtime_error("truncated weight frame");
+
+    std::vector<std::uint8_t> raw;
+    if (codec == WeightCodec::Raw) {
+        if (stored != raw_size)
+            throw std::runtime_error("corrupt weight frame");
+        raw.assign(p, p + stored);
+    } else {
+#if NEUROPET_HAS_ZSTD
+        detail::zstd_decompress(p, static_cast<std::size_t>(stored), raw_size, raw);
+#else
+        throw std::runtime_error("weight frame requires zstd support");
+#endif
+    }
+
+    WeightTensors out(count);
+    std::size_t off = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if (off + sizes[i] > raw.size())
+            throw std::runtime_error("corrupt weight frame");
+        out[i].resize(sizes[i]);
+        if (sizes[i])
+            std::memcpy(out[i].data(), raw.data() + off, sizes[i]);
+        off += sizes[i];
+    }
+    if (kind == WeightFrameKind::Delta) {
+        if (!base || !detail::same_layout(*base, out))
+            throw std::runtime_error("delta frame does not match base checkpoint");
+        for (std::uint32_t i = 0; i < count; ++i)
+            if (!out[i].empty())
+                detail::xor_bytes(reinterpret_cast<std::uint8_t*>(out[i].data()),
+                                  reinterpret_cast<const std::uint8_t*>((*base)[i].data()),
+                                  out[i].size());
+    }
+    if (info)
+        *info = {kind, epoch};
+    return out;
+}
+
+/**
+ * @brief Sequence of per-epoch checkpoints stored as keyframes plus deltas.
+ *
+ * Every ``keyframe_interval`` epochs (and whenever the tensor layout changes)
+ * a full keyframe is written so reconstructing any epoch replays at most
+ * ``keyframe_interval - 1`` deltas.
+ */
+class WeightDeltaChain {
+  public:
+    explicit WeightDeltaChain(std::uint32_t keyframe_interval = 16)
+        : interval_{keyframe_interval ? keyframe_interval : 1} {}
+
+    /** Append the checkpoint for the next epoch and return its index. */
+    std::uint32_t append(const WeightTensors& weights) {
+        std::uint32_t epoch = static_cast<std::uint32_t>(frames_.size());
+        bool key = epoch % interval_ == 0 || !detail::same_layout(last_, weights);
+        frames_.push_back(encode_weight_frame(key ? nullptr : &last_, weights, epoch));
+        keyframe_.push_back(key);
+        last_ = weights;
+        return epoch;
+    }
+
+    /** Rebuild the checkpoint stored for ``epoch``. */
+    WeightTensors reconstruct(std::uint32_t epoch) const {
+        if (epoch >= frames_.size())
+            throw std::out_of_range("epoch not in chain");
+        std::uint32_t k = epoch;
+        while (k > 0 && !keyframe_[k])
+            --k;
+        if (!keyframe_[k])
+            throw std::runtime_error("weight chain does not start with a keyframe");
+        WeightTensors cur = apply_weight_frame(nullptr, frames_[k]);
+        for (std::uint32_t e = k + 1; e <= epoch; ++e)
+            cur = apply_weight_frame(&cur, frames_[e]);
+        return cur;
+    }
+
+    std::size_t size() const { return frames_.size(); }
+
+    const std::vector<std::uint8_t>& frame(std::uint32_t epoch) const { return frames_.at(epoch); }
+
+    /** Total encoded size of all frames in bytes. */
+    std::size_t bytes() const {
+        std::size_t n = 0;
+        for (const auto& f : frames_)
+            n += f.size();
+        return n;
+    }
+
+    /** Write the chain as ``NPWC`` followed by length-prefixed frames. */
+    void save(std::ostream& out) const {
+        out.write("NPWC", 4);
+        write_u32(out, interval_);
+        write_u32(out, static_cast<std::uint32_t>(frames_.size()));
+        for (const auto& f : frames_) {
+            write_u32(out, static_cast<std::uint32_t>(f.size()));
+            out.write(reinterpret_cast<const char*>(f.data()), f.size());
+        }
+    }
+
+    static WeightDeltaChain load(std::istream& in) {
+        char magic[4];
+        in.read(magic, 4);
+        if (!in || std::string(magic, 4) != "NPWC")
+            throw std::runtime_error("invalid weight chain");
+        WeightDeltaChain chain(read_u32(in));
+        std::uint32_t count = read_u32(in);
+        WeightTensors cur;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            // Read in bounded blocks so a forged length fails on the short
+            // stream instead of allocating the full size up front.
+            const std::uint32_t len = read_u32(in);
+            std::vector<std::uint8_t> f;
+            while (f.size() < len) {
+                std::size_t off = f.size();
+                f.resize(off + std::min<std::size_t>(len - off, std::size_t{1} << 20));
+                in.read(reinterpret_cast<char*>(f.data() + off),
+                        static_cast<std::streamsize>(f.size() - off));
+                if (!in)
+                    throw std::runtime_error("truncated weight chain");
+            }
+            WeightFrameInfo info;
+            cur = apply_weight_frame(&cur, f, &info);
+            if (i == 0 && info.kind != WeightFrameKind::Keyframe)
+                throw std::runtime_error("weight chain does not start with a keyframe");
+            if (info.epoch != i)
+                throw std::runtime_error("weight chain epochs out of order");
+            chain.keyframe_.push_back(info.kind == WeightFrameKind::Keyframe);
+            chain.frames_.push_back(std::move(f));
+        }
+        chain.last_ = std::move(cur);
+        return chain;
+    }
+
+  private:
+    std::uint32_t interval_{16};
+    std::vector<std::vector<std::uint8_t>> frames_{};
+    std::vector<bool> keyframe_{};
+    WeightTensors last_{};
+};
+
+} // namespace neuropet
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "neuropet/battle.hpp"
+#include "neuropet/compiled_board.hpp"
+#include "neuropet/int8_spec.hpp"
+#include "neuropet/item.hpp"
+#include "neuropet/parallel.hpp"
+
+namespace neuropet {
+
+/** Stat profile evaluated by ``compute_win_matrix``. */
+struct BalanceProfile {
+    int power{0};
+    int defense{0};
+    int stamina{0};
+    std::uint32_t loadout{0};
+};
+
+/** Inputs of a ``compute_win_matrix`` run. */
+struct WinMatrixConfig {
+    /// Inclusive range of every base stat, as in ``random_creature``.
+    int stat_min{1};
+    int stat_max{10};
+    /// Item sets crossed with every stat combination; ``{}`` means no items.
+    std::vector<std::vector<Item>> loadouts{{}};
+    /// Seeds every matchup is fought under.
+    std::vector<std::uint32_t> seeds{1, 2};
+    /// Board layouts every matchup is fought on.
+    std::vector<BattleEngine> boards{BattleEngine{}};
+    /// Worker threads; zero selects all hardware threads.
+    unsigned threads{0};
+};
+
+/** Aggregates over the rows of a ``WinMatrix``. */
+struct WinMatrixSummary {
+    double mean{0.0};
+    double stddev{0.0};
+    double min{0.0};
+    double max{0.0};
+    std::size_t best{0};
+    std::size_t worst{0};
+};
+
+/**
+ * @brief Pairwise win counts between stat profiles.
+ *
+ * Cell ``(i, j)`` counts how often profile ``i`` beat profile ``j`` out of
+ * ``battles_per_cell`` fights with ``i`` starting in the top-left corner.
+ * Profile ``i`` fights as creature id ``i + 1`` in its row and as
+ * ``i + 1 + size()`` in its column, so mirror matches have distinct ids.
+ */
+struct WinMatrix {
+    std::vector<BalanceProfile> profiles{};
+    std::uint32_t battles_per_cell{0};
+    std::vector<std::uint16_t> wins{};
+
+    std::size_t size() const { return profiles.size(); }
+
+    std::uint16_t win_count(std::size_t i, std::size_t j) const { return wins[i * size() + j]; }
+
+    double win_rate(std::size_t i, std::size_t j) const {
+        return battles_per_cell ? static_cast<double>(win_count(i, j)) / battles_per_cell : 0.0;
+    }
+
+    /** Mean win rate of profile ``i`` against every profile. */
+    double profile_win_rate(std::size_t i) const {
+        if (!battles_per_cell || profiles.empty())
+            return 0.0;
+        std::uint64_t total = 0;
+        for (std::size_t j = 0; j < size(); ++j)
+            total += win_count(i, j);
+        return static_cast<double>(total) / (static_cast<double>(battles_per_cell) * size());
+    }
+
+    WinMatrixSummary summary() const {
+        WinMatrixSummary s;
+        if (profiles.empty())
+            return s;
+        s.min = 1.0;
+        double sq = 0.0;
+        for (std::size_t i = 0; i < size(); ++i) {
+            double r = profile_win_rate(i);
+            s.mean += r;
+            sq += r * r;
+            if (r > s.max) {
+                s.max = r;
+                s.best = i;
+            }
+            if (r < s.min) {
+                s.min = r;
+                s.worst = i;
+            }
+        }
+        s.mean /= static_cast<double>(size());
+        s.stddev = std::sqrt(std::max(0.0, sq / static_cast<double>(size()) - s.mean * s.mean));
+        return s;
+    }
+
+    /**
+     * Write as ``NPWM``, version, profile count and battles per cell, then one
+     * ``{power, defense, stamina, loadout}`` row per profile and the counts in
+     * row-major order.
+     */
+    void save(std::ostream& out) const {
+        out.write("NPWM", 4);
+        write_u32(out, 1); // version
+        write_u32(out, static_cast<std::uint32_t>(profiles.size()));
+        write_u32(out, battles_per_cell);
+        for (const auto& p : profiles) {
+            write_u32(out, static_cast<std::uint32_t>(p.power));
+            write_u32(out, static_cast<std::uint32_t>(p.defense));
+            write_u32(out, static_cast<std::uint32_t>(p.stamina));
+            write_u32(out, p.loadout);
+        }
+        out.write(reinterpret_cast<const char*>(wins.data()),
+                  static_cast<std::streamsize>(wins.size() * sizeof(std::uint16_t)));
+    }
+
+    static WinMatrix load(std::istream& in) {
+        char magic[4];
+        in.read(magic, 4);
+        if (!in || std::string(magic, 4) != "NPWM")
+            throw std::runtime_error("invalid win matrix");
+        if (read_u32(in) != 1)
+            throw std::runtime_error("unsupported win matrix version");
+        WinMatrix m;
+        m.profiles.resize(read_u32(in));
+        m.battles_per_cell = read_u32(in);
+        for (auto& p : m.profiles) {
+            p.power = static_cast<int>(read_u32(in));
+            p.defense = static_cast<int>(read_u32(in));
+            p.stamina = static_cast<int>(read_u32(in));
+            p.loadout = read_u32(in);
+        }
+        m.wins.resize(m.profiles.size() * m.profiles.size());
+        in.read(reinterpret_cast<char*>(m.wins.data()),
+                static_cast<std::streamsize>(m.wins.size() * sizeof(std::uint16_t)));
+        if (!in)
+            throw std::runtime_error("truncated win matrix");
+        return m;
+    }
+};
+
+/**
+ * @brief Fight every pair of stat profiles under every seed and board.
+ *
+ * Profiles enumerate ``[stat_min, stat_max]`` for power, defense and stamina
+ * crossed with ``loadouts``. Each board is compiled once into a
+ * ``CompiledBoard`` and rows of the matrix are resolved as ``BattleBatch``
+ * runs spread across ``threads`` workers. A fight only observes the parity
+ * of its seed (seed zero falls back to the creature ids), so seeds are folded
+ * into even, odd and zero classes and each class is fought once per pair
+ * with its multiplicity added to the count. Results match calling
+ * ``BattleEngine::fight`` for every pair, seed and board. Throws
+ * ``std::runtime_error`` if a cell would exceed 65535 battles or a board
+ * keeps the creatures apart.
+ */
+inline WinMatrix compute_win_matrix(const WinMatrixConfig& cfg) {
+    if (cfg.stat_min > cfg.stat_max || cfg.loadouts.empty())
+        throw std::runtime_error("empty profile space");
+    std::uint64_t per_cell = static_cast<std::uint64_t>(cfg.seeds.size()) * cfg.boards.size();
+    if (per_cell > 0xFFFFu)
+        throw std::runtime_error("too many battles per matrix cell");
+
+    WinMatrix m;
+    m.battles_per_cell = static_cast<std::uint32_t>(per_cell);
+    std::vector<CompactCreature> fighters;
+    for (std::uint32_t l = 0; l < cfg.loadouts.size(); ++l)
+        for (int p = cfg.stat_min; p <= cfg.stat_max; ++p)
+            for (int d = cfg.stat_min; d <= cfg.stat_max; ++d)
+                for (int s = cfg.stat_min; s <= cfg.stat_max; ++s) {
+                    CompactCreature c(static_cast<std::uint32_t>(fighters.size() + 1), p, d, s);
+                    for (const auto& item : cfg.loadouts[l])
+                        c.attach_item(item);
+                    fighters.push_back(c);
+                    m.profiles.push_back({p, d, s, l});
+                }
+    const std::size_t n = fighters.size();
+    m.wins.assign(n * n, 0);
+
+    struct SeedClass {
+        std::uint32_t seed;
+        std::uint16_t count;
+    };
+    std::vector<SeedClass> classes;
+    std::uint16_t counts[3] = {0, 0, 0};
+    for (std::uint32_t s : cfg.seeds)
+        ++counts[s == 0 ? 2 : (s & 1u)];
+    const std::uint32_t representative[3] = {2, 1, 0};
+    for (int c = 0; c < 3; ++c)
+        if (counts[c])
+            classes.push_back({representative[c], counts[c]});
+
+    for (const auto& engine : cfg.boards) {
+        CompiledBoard board(engine);
+        parallel_for(n, cfg.threads, [&](std::size_t i) {
+            BattleBatch batch;
+            batch.reserve(n * classes.size());
+            for (std::size_t j = 0; j < n; ++j) {
+                CompactCreature rival = fighters[j];
+                rival.id += static_cast<std::uint32_t>(n);
+                for (const auto& c : classes)
+                    batch.add(fighters[i], rival, c.seed);
+            }
+            auto winners = board.fight_batch(batch);
+            std::uint16_t* row = m.wins.data() + i * n;
+            std::size_t k = 0;
+            for (std::size_t j = 0; j < n; ++j)
+                for (const auto& c : classes)
+                    if (winners[k++] == fighters[i].id)
+                        row[j] = static_cast<std::uint16_t>(row[j] + c.count);
+        });
+    }
+    return m;
+}
+
+} // namespace neuropet
@@ -10,6 +10,12 @@ struct zk_proof_raw {
     char root[65];
     char proof[65];
 };
+
+/// One contiguous piece of the prover input for the gather entry points.
+struct zk_chunk {
+    const int8_t* data;
+    std::size_t size;
+};
 }
 
 namespace neuropet {
@@ -23,14 +29,25 @@ class ZkProofSystem : public IProofSystem {
     bool verify_proof(const std::vector<std::vector<int8_t>>& tensors,
                       const StarkProof& proof) const override;
 
+    StarkProof generate_proof(const TensorView* tensors, std::size_t count) const override;
+    bool verify_proof(const TensorView* tensors, std::size_t count,
+                      const StarkProof& proof) const override;
+
+    /** True when the prover exports the gather entry points. */
+    bool supports_gather() const { return gen_gather_ && verify_gather_; }
+
   private:
     ZkProofSystem();
     ~ZkProofSystem();
     using GenerateFn = void (*)(const int8_t*, std::size_t, zk_proof_raw*);
     using VerifyFn = bool (*)(const int8_t*, std::size_t, const zk_proof_raw*);
+    using GenerateGatherFn = void (*)(const zk_chunk*, std::size_t, zk_proof_raw*);
+    using VerifyGatherFn = bool (*)(const zk_chunk*, std::size_t, const zk_proof_raw*);
     void* handle_{nullptr};
     GenerateFn gen_{nullptr};
     VerifyFn verify_{nullptr};
+    GenerateGatherFn gen_gather_{nullptr};
+    VerifyGatherFn verify_gather_{nullptr};
 };
 
 } // namespace neuropet
@@ -1,5 +1,6 @@
 #include "neuropet/zk_proof_system.hpp"
 #include <cstring>
+#include <vector>
 #if defined(_WIN32)
 #include <windows.h>
 #elif defined(__unix__) || defined(__APPLE__)
@@ -51,6 +52,10 @@ ZkProofSystem::ZkProofSystem() {
     if (handle_) {
         gen_ = reinterpret_cast<GenerateFn>(dlsym(handle_, "zk_generate_proof"));
         verify_ = reinterpret_cast<VerifyFn>(dlsym(handle_, "zk_verify_proof"));
+        gen_gather_ =
+            reinterpret_cast<GenerateGatherFn>(dlsym(handle_, "zk_generate_proof_gather"));
+        verify_gather_ =
+            reinterpret_cast<VerifyGatherFn>(dlsym(handle_, "zk_verify_proof_gather"));
     }
 #elif defined(__unix__)
     const char* path = std::getenv("ZK_PROVER_PATH");
@@ -72,6 +77,10 @@ ZkProofSystem::ZkProofSystem() {
     if (handle_) {
         gen_ = reinterpret_cast<GenerateFn>(dlsym(handle_, "zk_generate_proof"));
         verify_ = reinterpret_cast<VerifyFn>(dlsym(handle_, "zk_verify_proof"));
+        gen_gather_ =
+            reinterpret_cast<GenerateGatherFn>(dlsym(handle_, "zk_generate_proof_gather"));
+        verify_gather_ =
+            reinterpret_cast<VerifyGatherFn>(dlsym(handle_, "zk_verify_proof_gather"));
     }
 #elif defined(_WIN32)
     const char* path = std::getenv("ZK_PROVER_PATH");
@@ -95,6 +104,10 @@ ZkProofSystem::ZkProofSystem() {
             GetProcAddress(static_cast<HMODULE>(handle_), "zk_generate_proof"));
         verify_ = reinterpret_cast<VerifyFn>(
             GetProcAddress(static_cast<HMODULE>(handle_), "zk_verify_proof"));
+        gen_gather_ = reinterpret_cast<GenerateGatherFn>(
+            GetProcAddress(static_cast<HMODULE>(handle_), "zk_generate_proof_gather"));
+        verify_gather_ = reinterpret_cast<VerifyGatherFn>(
+            GetProcAddress(static_cast<HMODULE>(handle_), "zk_verify_proof_gather"));
     }
 #endif
     if (!gen_ || !verify_) {
@@ -115,47 +128,91 @@ ZkProofSystem::~ZkProofSystem() {
 #endif
 }
 
+namespace {
+
 /**
- * @brief Collate tensors and invoke the external prover to produce a proof.
- *
- * The tensors are flattened into a single contiguous buffer before calling into
- * the dynamically loaded prover. Loss information is appended using
- * ``compute_loss`` so that verifiers can compare it against the original
- * inputs.
+ * Present ``count`` views to a prover entry point. With a gather entry the
+ * views are streamed as chunks straight from caller memory; a single view
+ * goes to the contiguous entry as is. Only several views without a gather
+ * entry are concatenated, into a per-thread buffer reused across calls.
  */
-StarkProof ZkProofSystem::generate_proof(const std::vector<std::vector<int8_t>>& tensors) const {
-    std::vector<int8_t> buf;
-    for (const auto& t : tensors) {
-        buf.insert(buf.end(), t.begin(), t.end());
+template <class Gather, class Contiguous>
+auto with_prover_input(const neuropet::TensorView* tensors, std::size_t count, Gather&& gather,
+                       bool has_gather, Contiguous&& contiguous) {
+    if (has_gather) {
+        std::vector<zk_chunk> chunks(count);
+        for (std::size_t i = 0; i < count; ++i)
+            chunks[i] = {tensors[i].data, tensors[i].size};
+        return gather(chunks.data(), chunks.size());
     }
+    if (count == 1)
+        return contiguous(tensors[0].data, tensors[0].size);
+    static thread_local std::vector<int8_t> buf;
+    buf.clear();
+    for (std::size_t i = 0; i < count; ++i)
+        buf.insert(buf.end(), tensors[i].data, tensors[i].data + tensors[i].size);
+    return contiguous(buf.data(), buf.size());
+}
+
+} // namespace
+
+/**
+ * @brief Invoke the external prover on tensor views without copying them.
+ *
+ * Loss information is appended using ``compute_loss`` so that verifiers can
+ * compare it against the original inputs.
+ */
+StarkProof ZkProofSystem::generate_proof(const TensorView* tensors, std::size_t count) const {
     zk_proof_raw raw{};
-    gen_(buf.data(), buf.size(), &raw);
+    with_prover_input(
+        tensors, count,
+        [&](const zk_chunk* chunks, std::size_t n) {
+            gen_gather_(chunks, n, &raw);
+            return true;
+        },
+        gen_gather_ != nullptr,
+        [&](const int8_t* data, std::size_t size) {
+            gen_(data, size, &raw);
+            return true;
+        });
     StarkProof p{};
     p.root = std::string(raw.root);
     p.proof = std::string(raw.proof);
-    p.loss = compute_loss(tensors);
+    p.loss = compute_loss(tensors, count);
     return p;
 }
 
 /**
- * @brief Verify a proof against a sequence of tensors.
+ * @brief Verify a proof against tensor views.
  *
- * The input tensors are flattened using the same layout as in
- * ``generate_proof`` before being passed to the verifier entry point. The proof
- * strings are copied into the raw structure expected by the C API.
+ * The views are presented to the verifier with the same layout as in
+ * ``generate_proof``. The proof strings are copied into the raw structure
+ * expected by the C API.
  */
-bool ZkProofSystem::verify_proof(const std::vector<std::vector<int8_t>>& tensors,
+bool ZkProofSystem::verify_proof(const TensorView* tensors, std::size_t count,
                                  const StarkProof& proof) const {
-    std::vector<int8_t> buf;
-    for (const auto& t : tensors) {
-        buf.insert(buf.end(), t.begin(), t.end());
-    }
     zk_proof_raw raw{};
     std::snprintf(raw.root, sizeof(raw.root), "%s", proof.root.c_str());
     std::snprintf(raw.proof, sizeof(raw.proof), "%s", proof.proof.c_str());
-    if (!verify_(buf.data(), buf.size(), &raw))
+    bool ok = with_prover_input(
+        tensors, count,
+        [&](const zk_chunk* chunks, std::size_t n) { return verify_gather_(chunks, n, &raw); },
+        verify_gather_ != nullptr,
+        [&](const int8_t* data, std::size_t size) { return verify_(data, size, &raw); });
+    if (!ok)
         return false;
-    return compute_loss(tensors) == proof.loss;
+    return compute_loss(tensors, count) == proof.loss;
+}
+
+StarkProof ZkProofSystem::generate_proof(const std::vector<std::vector<int8_t>>& tensors) const {
+    auto views = tensor_views(tensors);
+    return generate_proof(views.data(), views.size());
+}
+
+bool ZkProofSystem::verify_proof(const std::vector<std::vector<int8_t>>& tensors,
+                                 const StarkProof& proof) const {
+    auto views = tensor_views(tensors);
+    return verify_proof(views.data(), views.size(), proof);
 }
 
 } // namespace neuropet
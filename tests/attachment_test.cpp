@@ -1,6 +1,8 @@
 #include "neuropet/battle.hpp"
 #include <gtest/gtest.h>
 
+#include <type_traits>
+
 TEST(BattleItemTest, AttachmentsAffectOutcome) {
     neuropet::CreatureStats a{1, 1, 1, 1};
     neuropet::CreatureStats b{2, 2, 2, 2};
@@ -13,6 +15,64 @@ TEST(BattleItemTest, AttachmentsAffectOutcome) {
     EXPECT_EQ(winner, 1u);
 }
 
+TEST(BattleItemTest, CompactCreatureCachesTotals) {
+    static_assert(std::is_trivially_copyable_v<neuropet::CompactCreature>);
+    neuropet::CompactCreature c{7, 2, 3, 4};
+    c.attach_item({1, 1, 1, 1});
+    c.attach_item({2, 5, -2, 0});
+    c.attach_item({3, 0, 0, 3});
+    EXPECT_EQ(c.total_power(), 8);
+    EXPECT_EQ(c.total_defense(), 2);
+    EXPECT_EQ(c.total_stamina(), 8);
+    c.detach_item(2);
+    EXPECT_EQ(c.item_count(), 2u);
+    EXPECT_EQ(c.item(1).id, 3u);
+    EXPECT_EQ(c.total_power(), 3);
+    EXPECT_EQ(c.total_defense(), 4);
+    c.detach_item(99);
+    EXPECT_EQ(c.item_count(), 2u);
+
+    auto stats = c.to_stats();
+    EXPECT_EQ(stats.total_power(), c.total_power());
+    EXPECT_EQ(stats.total_defense(), c.total_defense());
+    EXPECT_EQ(stats.total_stamina(), c.total_stamina());
+}
+
+TEST(BattleItemTest, CompactCreatureFightsLikeCreatureStats) {
+    neuropet::CreatureStats a{1, 1, 1, 1};
+    neuropet::CreatureStats b{2, 2, 2, 2};
+    a.attach_item({1, 3, 3, 3});
+    neuropet::BattleEngine engine;
+    neuropet::CompactCreature ca(a);
+    neuropet::CompactCreature cb(b);
+    EXPECT_EQ(engine.fight(ca, cb, 1), engine.fight(a, b, 1));
+    EXPECT_EQ(engine.fight(cb, ca, 2), engine.fight(b, a, 2));
+}
+
+TEST(BattleItemTest, CompactCreatureFoldsItemsBeyondInlineSlots) {
+    neuropet::CreatureStats a{1, 1, 1, 1};
+    neuropet::CreatureStats b{2, 9, 9, 9};
+    for (std::uint32_t i = 0; i < neuropet::CompactCreature::kMaxItems + 4; ++i)
+        a.attach_item({i, 1, 1, 1});
+    neuropet::CompactCreature ca(a);
+    EXPECT_EQ(ca.item_count(), neuropet::CompactCreature::kMaxItems);
+    EXPECT_EQ(ca.total_power(), a.total_power());
+    EXPECT_EQ(ca.total_defense(), a.total_defense());
+    EXPECT_EQ(ca.total_stamina(), a.total_stamina());
+    EXPECT_EQ(ca.to_stats().total_power(), a.total_power());
+    neuropet::BattleEngine engine;
+    neuropet::CompactCreature cb(b);
+    for (std::uint32_t seed = 1; seed < 4; ++seed)
+        EXPECT_EQ(engine.fight(ca, cb, seed), engine.fight(a, b, seed));
+
+    neuropet::Matchmaker mm;
+    mm.enqueue(a);
+    mm.enqueue(b);
+    EXPECT_EQ(mm.try_match(1), engine.fight(a, b, 1));
+
+    EXPECT_THROW(ca.attach_item({99, 0, 0, 0}), std::runtime_error);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
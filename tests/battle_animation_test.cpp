@@ -1,6 +1,9 @@
 #include "neuropet/battle_animation.hpp"
 #include <gtest/gtest.h>
 
+#include <random>
+#include <sstream>
+
 TEST(BattleAnimationTest, RecordsDeterministicFrames) {
     neuropet::CreatureStats a{1, 1, 1, 2};
     neuropet::CreatureStats b{2, 1, 1, 2};
@@ -19,6 +22,117 @@ TEST(BattleAnimationTest, RecordsDeterministicFrames) {
     EXPECT_EQ(replay_winner, anim.winner());
 }
 
+TEST(BattleAnimationTest, DeltaStreamRoundTrips) {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> stat(1, 40);
+    for (std::uint32_t i = 0; i < 50; ++i) {
+        neuropet::CreatureStats a{2 * i + 1, stat(rng), stat(rng), stat(rng)};
+        neuropet::CreatureStats b{2 * i + 2, stat(rng), stat(rng), stat(rng)};
+        neuropet::BattleAnimator anim;
+        anim.run(a, b, i);
+
+        std::stringstream ss;
+        neuropet::BattleFrameWriter writer(ss);
+        for (const auto& f : anim.frames())
+            writer.write(f);
+        EXPECT_EQ(writer.frames(), anim.frames().size());
+        EXPECT_LT(writer.bytes(), 20 * anim.frames().size() / 2 + 1);
+
+        std::string bytes = ss.str();
+        neuropet::BattleFrameReader mem(reinterpret_cast<const std::uint8_t*>(bytes.data()),
+                                        bytes.size());
+        std::vector<neuropet::BattleFrame> decoded(mem.begin(), mem.end());
+        ASSERT_EQ(decoded.size(), anim.frames().size());
+        for (std::size_t k = 0; k < decoded.size(); ++k) {
+            EXPECT_EQ(decoded[k].attacker_is_a, anim.frames()[k].attacker_is_a);
+            EXPECT_EQ(decoded[k].hp_a, anim.frames()[k].hp_a);
+            EXPECT_EQ(decoded[k].hp_b, anim.frames()[k].hp_b);
+            EXPECT_EQ(decoded[k].stamina_a, anim.frames()[k].stamina_a);
+            EXPECT_EQ(decoded[k].stamina_b, anim.frames()[k].stamina_b);
+        }
+
+        // A tiny buffer forces varints across refills.
+        std::istringstream in(bytes);
+        neuropet::BattleFrameReader streamed(in, 3);
+        EXPECT_EQ(neuropet::BattleAnimator::replay(a, b, streamed.begin(), streamed.end()),
+                  anim.winner());
+
+        std::stringstream recorded;
+        neuropet::BattleFrameWriter direct(recorded);
+        neuropet::BattleAnimator streamer;
+        streamer.record(a, b, i, direct);
+        EXPECT_EQ(recorded.str(), bytes);
+        EXPECT_EQ(streamer.winner(), anim.winner());
+    }
+}
+
+TEST(BattleAnimationTest, StreamReplayRejectsTampering) {
+    neuropet::CreatureStats a{1, 3, 9, 5};
+    neuropet::CreatureStats b{2, 2, 10, 5};
+    neuropet::BattleAnimator anim;
+    anim.run(a, b, 7);
+    ASSERT_GT(anim.frames().size(), 1u);
+    auto frames = anim.frames();
+    frames[1].hp_b += 1;
+
+    std::stringstream ss;
+    neuropet::BattleFrameWriter writer(ss);
+    for (const auto& f : frames)
+        writer.write(f);
+    neuropet::BattleFrameReader reader(ss);
+    EXPECT_EQ(neuropet::BattleAnimator::replay(a, b, reader.begin(), reader.end()), 0u);
+
+    std::string bytes = ss.str();
+    bytes.pop_back();
+    std::istringstream cut(bytes);
+    neuropet::BattleFrameReader truncated(cut);
+    neuropet::BattleFrame f;
+    EXPECT_THROW(
+        {
+            while (truncated.next(f))
+                ;
+        },
+        std::runtime_error);
+}
+
+TEST(BattleAnimationTest, ReplayBatchMatchesSequentialReplay) {
+    std::mt19937 rng(8);
+    std::uniform_int_distribution<int> stat(1, 60);
+    std::vector<neuropet::CreatureStats> creatures;
+    std::vector<std::vector<neuropet::BattleFrame>> frames;
+    for (std::uint32_t i = 0; i < 300; ++i)
+        creatures.push_back({i + 1, stat(rng), stat(rng), stat(rng)});
+    for (std::uint32_t i = 0; i < 150; ++i) {
+        neuropet::BattleAnimator anim;
+        anim.run(creatures[2 * i], creatures[2 * i + 1], i);
+        frames.push_back(anim.frames());
+    }
+    frames[17][0].hp_a += 1;
+    std::vector<neuropet::ReplayTask> tasks;
+    for (std::size_t i = 0; i < frames.size(); ++i)
+        tasks.push_back({&creatures[2 * i], &creatures[2 * i + 1], &frames[i]});
+
+    auto serial = neuropet::BattleAnimator::replay_batch(tasks, 1);
+    ASSERT_EQ(serial.winners.size(), tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+        EXPECT_EQ(serial.winners[i],
+                  neuropet::BattleAnimator::replay(*tasks[i].a, *tasks[i].b, frames[i]));
+    EXPECT_EQ(serial.winners[17], 0u);
+    EXPECT_EQ(serial.failed, 1u);
+
+    auto parallel = neuropet::BattleAnimator::replay_batch(tasks, 4, 16);
+    EXPECT_EQ(parallel.winners, serial.winners);
+    EXPECT_EQ(parallel.digest, serial.digest);
+
+    frames[17][0].hp_a -= 1;
+    auto fixed = neuropet::BattleAnimator::replay_batch(tasks, 3);
+    EXPECT_EQ(fixed.failed, 0u);
+    EXPECT_NE(fixed.digest, serial.digest);
+
+    tasks[3].frames = nullptr;
+    EXPECT_THROW(neuropet::BattleAnimator::replay_batch(tasks), std::runtime_error);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
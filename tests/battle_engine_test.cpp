@@ -1,6 +1,8 @@
 #include "neuropet/battle.hpp"
 #include <gtest/gtest.h>
 
+#include <random>
+
 TEST(BattleEngineTest, MovementWallsAndHazards) {
     neuropet::BattleEngine engine;
     engine.set_tile(1, 0, neuropet::BattleEngine::Tile::HAZARD);
@@ -20,6 +22,75 @@ TEST(BattleEngineTest, BlockingReducesDamage) {
     EXPECT_EQ(engine.fight(a, b, 0), 1u);
 }
 
+TEST(BattleEngineTest, FightBatchMatchesFight) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> stat(0, 12);
+    std::uniform_int_distribution<int> tile(0, 9);
+    for (int board = 0; board < 40; ++board) {
+        neuropet::BattleEngine engine;
+        for (int x = 0; x < 8; ++x)
+            for (int y = 0; y < 8; ++y) {
+                int t = tile(rng);
+                if (board % 4 == 0 || (x + y) % 7 == 0)
+                    continue;
+                if (t == 0)
+                    engine.set_tile(x, y, neuropet::BattleEngine::Tile::WALL);
+                else if (t < 3)
+                    engine.set_tile(x, y, neuropet::BattleEngine::Tile::HAZARD);
+            }
+        neuropet::BattleBatch batch;
+        std::vector<std::pair<neuropet::CreatureStats, neuropet::CreatureStats>> pairs;
+        std::vector<std::uint32_t> seeds;
+        for (std::uint32_t i = 0; i < 37; ++i) {
+            neuropet::CreatureStats a{2 * i + 1, stat(rng), stat(rng), stat(rng)};
+            neuropet::CreatureStats b{2 * i + 2, stat(rng), stat(rng), stat(rng)};
+            if (i % 3 == 0)
+                a.attach_item({1, stat(rng) - 6, stat(rng) - 6, stat(rng) - 6});
+            std::uint32_t seed = i % 2 ? rng() : 0;
+            batch.add(a, b, seed);
+            pairs.emplace_back(a, b);
+            seeds.push_back(seed);
+        }
+        std::vector<std::uint32_t> winners;
+        try {
+            winners = engine.fight_batch(batch);
+        } catch (const std::runtime_error&) {
+            continue; // walls keep the creatures apart; fight() would not return
+        }
+        ASSERT_EQ(winners.size(), pairs.size());
+        for (std::size_t i = 0; i < pairs.size(); ++i)
+            EXPECT_EQ(winners[i], engine.fight(pairs[i].first, pairs[i].second, seeds[i]))
+                << "board " << board << " pair " << i;
+    }
+}
+
+TEST(BattleEngineTest, BitboardTilesAndNeighbors) {
+    using neuropet::BattleEngine;
+    BattleEngine engine;
+    engine.set_tile(1, 2, BattleEngine::Tile::WALL);
+    engine.set_tile(6, 7, BattleEngine::Tile::HAZARD);
+    EXPECT_EQ(engine.walls(), BattleEngine::square(1, 2));
+    EXPECT_EQ(engine.hazards(), BattleEngine::square(6, 7));
+    EXPECT_EQ(engine.tile_at(1, 2), BattleEngine::Tile::WALL);
+    EXPECT_EQ(engine.tile_at(6, 7), BattleEngine::Tile::HAZARD);
+    EXPECT_EQ(engine.tile_at(3, 3), BattleEngine::Tile::EMPTY);
+    EXPECT_EQ(engine.tile_at(-1, 0), BattleEngine::Tile::WALL);
+
+    engine.set_tile(1, 2, BattleEngine::Tile::HAZARD);
+    EXPECT_EQ(engine.walls(), 0u);
+    EXPECT_EQ(engine.tile_at(1, 2), BattleEngine::Tile::HAZARD);
+
+    EXPECT_EQ(BattleEngine::neighbors(0, 0), BattleEngine::square(1, 0) | BattleEngine::square(0, 1));
+    EXPECT_EQ(BattleEngine::neighbors(3, 4), BattleEngine::square(2, 4) | BattleEngine::square(4, 4) |
+                                                 BattleEngine::square(3, 3) | BattleEngine::square(3, 5));
+    EXPECT_EQ(BattleEngine::neighbors(7, 4), BattleEngine::square(6, 4) | BattleEngine::square(7, 3) |
+                                                 BattleEngine::square(7, 5));
+    EXPECT_EQ(BattleEngine::neighbors(8, 0), 0u);
+
+    BattleEngine copy = engine;
+    EXPECT_EQ(copy.board_digest(), engine.board_digest());
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,182 @@
+#include "neuropet/arena.hpp"
+#include "neuropet/concurrent_matchmaker.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <thread>
+
+using neuropet::BattleEngine;
+
+namespace {
+std::vector<neuropet::CreatureStats> random_roster(std::size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> stat(1, 10);
+    std::vector<neuropet::CreatureStats> out;
+    for (std::size_t i = 0; i < n; ++i)
+        out.push_back({static_cast<std::uint32_t>(i + 1), stat(rng), stat(rng), stat(rng)});
+    return out;
+}
+
+// Same SplitMix64 finalizer BattleEngine uses for ``board_digest``.
+std::uint64_t splitmix(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void set_walls(BattleEngine& engine, std::uint64_t walls) {
+    engine.clear_board();
+    for (int x = 0; x < 8; ++x)
+        for (int y = 0; y < 8; ++y)
+            if (walls >> (x * 8 + y) & 1u)
+                engine.set_tile(x, y, BattleEngine::Tile::WALL);
+}
+} // namespace
+
+TEST(BattleMemoTest, BoardDigestTracksTiles) {
+    BattleEngine engine;
+    EXPECT_EQ(engine.board_digest(), 0u);
+    engine.set_tile(2, 3, BattleEngine::Tile::HAZARD);
+    auto hazard = engine.board_digest();
+    EXPECT_NE(hazard, 0u);
+    engine.set_tile(2, 3, BattleEngine::Tile::WALL);
+    EXPECT_NE(engine.board_digest(), hazard);
+    engine.set_tile(2, 3, BattleEngine::Tile::HAZARD);
+    EXPECT_EQ(engine.board_digest(), hazard);
+    engine.set_tile(9, 9, BattleEngine::Tile::WALL);
+    EXPECT_EQ(engine.board_digest(), hazard);
+    engine.clear_board();
+    EXPECT_EQ(engine.board_digest(), 0u);
+}
+
+TEST(BattleMemoTest, MatchesFightAndCountsHits) {
+    BattleEngine engine;
+    engine.set_tile(3, 0, BattleEngine::Tile::HAZARD);
+    neuropet::BattleMemo memo;
+    auto roster = random_roster(20, 5);
+    for (int round = 0; round < 2; ++round)
+        for (const auto& a : roster)
+            for (const auto& b : roster)
+                for (std::uint32_t seed : {0u, 1u, 2u})
+                    ASSERT_EQ(memo.fight(engine, a, b, seed), engine.fight(a, b, seed));
+    EXPECT_GT(memo.hits(), memo.misses());
+    EXPECT_GT(memo.hit_rate(), 0.5);
+    memo.clear();
+    EXPECT_EQ(memo.hits() + memo.misses(), 0u);
+}
+
+TEST(BattleMemoTest, TileChangesInvalidateResults) {
+    // B cannot attack, so A wins unless a hazard in its corner knocks it out.
+    neuropet::CreatureStats a{1, 1, 1, 1};
+    neuropet::CreatureStats b{2, 1, 1, 0};
+    BattleEngine engine;
+    neuropet::BattleMemo memo;
+    EXPECT_EQ(memo.fight(engine, a, b, 2), 1u);
+    engine.set_tile(0, 0, BattleEngine::Tile::HAZARD);
+    ASSERT_EQ(engine.fight(a, b, 2), 2u);
+    EXPECT_EQ(memo.fight(engine, a, b, 2), 2u);
+    EXPECT_EQ(memo.hits(), 0u);
+}
+
+TEST(BattleMemoTest, DigestCollisionsDoNotShareResults) {
+    // A hazard on A's start square and a walls-only board equal to the mixed
+    // hazard bitboard share a digest. Neither side has stamina, so the winner
+    // is decided by the starting hazard alone.
+    neuropet::CreatureStats a{1, 1, 1, 0};
+    neuropet::CreatureStats b{2, 1, 1, 0};
+    BattleEngine hazard_board;
+    hazard_board.set_tile(0, 0, BattleEngine::Tile::HAZARD);
+    BattleEngine wall_board;
+    set_walls(wall_board, splitmix(hazard_board.hazards()));
+    ASSERT_EQ(hazard_board.board_digest(), wall_board.board_digest());
+    ASSERT_EQ(hazard_board.fight(a, b, 2), 2u);
+    ASSERT_EQ(wall_board.fight(a, b, 2), 1u);
+
+    neuropet::BattleMemo memo;
+    EXPECT_EQ(memo.fight(hazard_board, a, b, 2), 2u);
+    EXPECT_EQ(memo.fight(wall_board, a, b, 2), 1u);
+    EXPECT_EQ(memo.fight(hazard_board, a, b, 2), 2u);
+    EXPECT_EQ(memo.hits(), 0u);
+}
+
+TEST(BattleMemoTest, MemoryIsBounded) {
+    neuropet::BattleMemo memo({100, 3});
+    EXPECT_GE(memo.capacity(), 100u);
+    EXPECT_LE(memo.capacity(), 256u);
+    BattleEngine engine;
+    auto roster = random_roster(200, 9);
+    for (const auto& a : roster)
+        for (const auto& b : roster)
+            ASSERT_EQ(memo.fight(engine, a, b, 3), engine.fight(a, b, 3));
+    EXPECT_GE(memo.capacity(), 100u);
+    EXPECT_LE(memo.capacity(), 256u);
+}
+
+TEST(BattleMemoTest, ArenaAndMatchmakersUseMemo) {
+    neuropet::BattleMemo memo;
+    auto roster = random_roster(4, 2);
+    neuropet::MatchLedger plain_ledger;
+    neuropet::MatchLedger memo_ledger;
+    neuropet::Arena plain(BattleEngine(), &plain_ledger);
+    neuropet::Arena cached(BattleEngine(), &memo_ledger);
+    cached.set_memo(&memo);
+    neuropet::Matchmaker mm(BattleEngine(), &memo_ledger);
+    mm.set_memo(&memo);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(cached.battle(roster[0], roster[1], 7), plain.battle(roster[0], roster[1], 7));
+        mm.enqueue(roster[2]);
+        mm.enqueue(roster[3]);
+        mm.try_match(4);
+    }
+    EXPECT_EQ(memo.misses(), 2u);
+    EXPECT_EQ(memo.hits(), 4u);
+    EXPECT_EQ(memo_ledger.results().size(), 6u);
+}
+
+TEST(BattleMemoTest, SharedAcrossThreads) {
+    BattleEngine engine;
+    engine.set_tile(4, 4, BattleEngine::Tile::WALL);
+    neuropet::BattleMemo memo({1024, 8});
+    auto roster = random_roster(32, 11);
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches{0};
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&, t]() {
+            for (std::size_t i = 0; i < roster.size(); ++i)
+                for (std::size_t j = 0; j < roster.size(); ++j) {
+                    const auto& a = roster[(i + t) % roster.size()];
+                    const auto& b = roster[j];
+                    if (memo.fight(engine, a, b, 1) != engine.fight(a, b, 1))
+                        ++mismatches;
+                }
+        });
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(memo.hits() + memo.misses(), 4u * 32u * 32u);
+
+    neuropet::MatchLedger ledger;
+    neuropet::ConcurrentMatchmakerOptions opts;
+    opts.workers = 2;
+    opts.memo = &memo;
+    {
+        neuropet::ConcurrentMatchmaker cm(engine, &ledger, opts);
+        for (const auto& c : roster)
+            cm.enqueue(c);
+        cm.drain();
+    }
+    neuropet::MatchLedger expected;
+    neuropet::Matchmaker ref(engine, &expected);
+    for (const auto& c : roster)
+        ref.enqueue(c);
+    while (ref.try_match())
+        ;
+    ASSERT_EQ(ledger.results().size(), expected.results().size());
+    for (std::size_t i = 0; i < ledger.results().size(); ++i)
+        EXPECT_EQ(ledger.results()[i].winner, expected.results()[i].winner);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,82 @@
+#include "neuropet/training.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+
+static std::shared_ptr<const harmonics::HTensor> make_tensor(float v) {
+    auto t = std::make_shared<harmonics::HTensor>(harmonics::HTensor::DType::Float32,
+                                                  std::vector<std::size_t>{1});
+    t->data().resize(sizeof(float));
+    *reinterpret_cast<float*>(t->data().data()) = v;
+    return t;
+}
+
+static float value(const harmonics::HTensor& t) {
+    return *reinterpret_cast<const float*>(t.data().data());
+}
+
+TEST(CheckpointTest, SnapshotRoundTripIncludesOptimizerState) {
+    const char* path = "snapshot.ckpt";
+    neuropet::TrainingSnapshot snap;
+    snap.step = 42;
+    snap.params = {make_tensor(1.f), make_tensor(2.f)};
+    snap.opt1 = {make_tensor(3.f), make_tensor(4.f)};
+    snap.opt2 = {make_tensor(5.f), make_tensor(6.f)};
+    neuropet::save_training_snapshot(snap, path);
+    ASSERT_TRUE(neuropet::is_training_checkpoint(path));
+
+    auto st = neuropet::load_training_state(path);
+    EXPECT_EQ(st.step, 42u);
+    ASSERT_EQ(st.params.size(), 2u);
+    EXPECT_EQ(value(st.params[1]), 2.f);
+    EXPECT_EQ(value(st.opt1[0]), 3.f);
+    EXPECT_EQ(value(st.opt2[1]), 6.f);
+    std::remove(path);
+}
+
+TEST(CheckpointTest, WriterPersistsLatestSnapshot) {
+    const char* path = "writer.ckpt";
+    {
+        neuropet::CheckpointWriter writer(path);
+        for (std::uint64_t step = 1; step <= 5; ++step) {
+            neuropet::TrainingSnapshot snap;
+            snap.step = step;
+            snap.params = {make_tensor(static_cast<float>(step))};
+            snap.opt1 = {make_tensor(0.f)};
+            snap.opt2 = {make_tensor(0.f)};
+            writer.submit(std::move(snap));
+        }
+        writer.flush();
+        EXPECT_FALSE(writer.in_flight());
+        EXPECT_GE(writer.written(), 1u);
+    }
+    auto st = neuropet::load_training_state(path);
+    EXPECT_EQ(st.step, 5u);
+    EXPECT_EQ(value(st.params[0]), 5.f);
+    std::remove(path);
+}
+
+TEST(CheckpointTest, PipelineResumesFromPeriodicCheckpoint) {
+    const char* path = "pipeline.ckpt";
+    std::remove(path);
+    std::vector<std::uint32_t> steps;
+    auto run = [&](std::size_t n) {
+        neuropet::TrainingPipelineConfig cfg;
+        cfg.input = std::make_shared<neuropet::ConstantProducer>(1.0f, 1);
+        cfg.checkpoint.path = path;
+        cfg.checkpoint.interval = 2;
+        cfg.steps = n;
+        cfg.metrics = [&](const neuropet::TrainingMetrics& m) { steps.push_back(m.step); };
+        return neuropet::TrainingPipeline(std::move(cfg)).run();
+    };
+    EXPECT_EQ(run(3), 3u);
+    EXPECT_EQ(run(2), 5u);
+    ASSERT_EQ(steps.size(), 5u);
+    EXPECT_EQ(steps.back(), 5u);
+    EXPECT_EQ(neuropet::load_training_state(path).step, 5u);
+    std::remove(path);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
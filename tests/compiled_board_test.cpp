@@ -0,0 +1,65 @@
+#include "neuropet/compiled_board.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using neuropet::BattleEngine;
+
+TEST(CompiledBoardTest, MatchesReferenceOnRandomBoards) {
+    std::mt19937 rng(77);
+    std::uniform_int_distribution<int> stat(-2, 14);
+    std::uniform_int_distribution<int> tile(0, 9);
+    std::size_t checked = 0;
+    for (int board = 0; board < 200; ++board) {
+        BattleEngine engine;
+        for (int x = 0; x < 8; ++x)
+            for (int y = 0; y < 8; ++y) {
+                int t = tile(rng);
+                if (board % 5 == 0)
+                    continue;
+                if (t == 0 && board % 3)
+                    engine.set_tile(x, y, BattleEngine::Tile::WALL);
+                else if (t < 4)
+                    engine.set_tile(x, y, BattleEngine::Tile::HAZARD);
+            }
+        neuropet::CompiledBoard compiled(engine);
+        for (std::uint32_t i = 0; i < 200; ++i) {
+            neuropet::CreatureStats a{2 * i + 1, stat(rng), stat(rng), stat(rng)};
+            neuropet::CreatureStats b{2 * i + 2, stat(rng), stat(rng), stat(rng)};
+            if (i % 4 == 0)
+                b.attach_item({9, stat(rng) - 8, stat(rng), stat(rng) - 8});
+            std::uint32_t seed = i % 3 ? rng() : 0;
+            std::uint32_t winner;
+            try {
+                winner = compiled.fight(a, b, seed);
+            } catch (const std::runtime_error&) {
+                continue; // fight() would never return on this board
+            }
+            ASSERT_EQ(winner, engine.fight(a, b, seed))
+                << "board " << board << " a{" << a.total_power() << "," << a.total_defense()
+                << "," << a.total_stamina() << "} b{" << b.total_power() << ","
+                << b.total_defense() << "," << b.total_stamina() << "} seed " << seed;
+            ++checked;
+        }
+    }
+    EXPECT_GT(checked, 20000u);
+}
+
+TEST(CompiledBoardTest, BatchMatchesEngineBatch) {
+    BattleEngine engine;
+    engine.set_tile(0, 0, BattleEngine::Tile::HAZARD);
+    engine.set_tile(3, 0, BattleEngine::Tile::HAZARD);
+    engine.set_tile(7, 4, BattleEngine::Tile::WALL);
+    neuropet::BattleBatch batch;
+    for (std::uint32_t i = 0; i < 500; ++i) {
+        int p = static_cast<int>(i % 11);
+        batch.add({2 * i + 1, p, static_cast<int>(i % 13), static_cast<int>(i % 7)},
+                  {2 * i + 2, 10 - p, static_cast<int>(i % 9), static_cast<int>(i % 5)});
+    }
+    EXPECT_EQ(neuropet::CompiledBoard(engine).fight_batch(batch), engine.fight_batch(batch));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+#include "neuropet/concurrent_matchmaker.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static neuropet::CompactCreature creature(std::uint32_t id) {
+    return neuropet::CompactCreature{id, static_cast<int>(id % 7) + 1,
+                                     static_cast<int>(id % 5) + 1, static_cast<int>(id % 3) + 1};
+}
+
+TEST(ConcurrentMatchmakerTest, LedgerMatchesSequentialMatchmaker) {
+    neuropet::BattleEngine engine;
+    engine.set_tile(3, 3, neuropet::BattleEngine::Tile::HAZARD);
+    neuropet::MatchLedger expected;
+    neuropet::Matchmaker mm(engine, &expected);
+    for (std::uint32_t id = 1; id <= 1001; ++id) {
+        mm.enqueue(creature(id));
+        mm.try_match();
+    }
+    for (unsigned workers : {1u, 4u}) {
+        neuropet::MatchLedger ledger;
+        neuropet::ConcurrentMatchmakerOptions opts;
+        opts.workers = workers;
+        opts.capacity = 64;
+        neuropet::ConcurrentMatchmaker cmm(engine, &ledger, opts);
+        for (std::uint32_t id = 1; id <= 1001; ++id)
+            cmm.enqueue(creature(id));
+        cmm.drain();
+        EXPECT_EQ(cmm.matches(), 500u);
+        EXPECT_EQ(cmm.pending(), 1u);
+        ASSERT_EQ(ledger.results().size(), expected.results().size());
+        for (std::size_t i = 0; i < ledger.results().size(); ++i) {
+            EXPECT_EQ(ledger.results()[i].battle_id, expected.results()[i].battle_id);
+            EXPECT_EQ(ledger.results()[i].winner, expected.results()[i].winner);
+            EXPECT_EQ(ledger.results()[i].loser, expected.results()[i].loser);
+        }
+    }
+}
+
+TEST(ConcurrentMatchmakerTest, ManyProducersPairEveryCreature) {
+    neuropet::MatchLedger ledger;
+    neuropet::ConcurrentMatchmakerOptions opts;
+    opts.workers = 3;
+    opts.capacity = 128;
+    {
+        neuropet::ConcurrentMatchmaker cmm(neuropet::BattleEngine{}, &ledger, opts);
+        std::vector<std::thread> producers;
+        for (std::uint32_t p = 0; p < 4; ++p)
+            producers.emplace_back([&, p]() {
+                for (std::uint32_t i = 0; i < 500; ++i)
+                    cmm.enqueue(creature(p * 1000 + i + 1));
+            });
+        for (auto& t : producers)
+            t.join();
+        cmm.drain();
+        EXPECT_EQ(cmm.pending(), 0u);
+    }
+    ASSERT_EQ(ledger.results().size(), 1000u);
+    std::vector<int> seen(4001, 0);
+    for (std::size_t i = 0; i < ledger.results().size(); ++i) {
+        const auto& r = ledger.results()[i];
+        EXPECT_EQ(r.battle_id, i + 1);
+        ++seen[r.winner];
+        ++seen[r.loser];
+    }
+    for (std::uint32_t p = 0; p < 4; ++p)
+        for (std::uint32_t i = 0; i < 500; ++i)
+            EXPECT_EQ(seen[p * 1000 + i + 1], 1);
+}
+
+TEST(ConcurrentMatchmakerTest, WakesIdlePairerForEveryCreature) {
+    neuropet::MatchLedger ledger;
+    neuropet::ConcurrentMatchmakerOptions opts;
+    opts.workers = 2;
+    opts.capacity = 16;
+    neuropet::ConcurrentMatchmaker cmm(neuropet::BattleEngine{}, &ledger, opts);
+    for (std::uint32_t round = 0; round < 200; ++round) {
+        // Let the pairing thread go back to sleep between creatures.
+        std::this_thread::sleep_for(std::chrono::microseconds(round % 4 == 0 ? 200 : 0));
+        cmm.enqueue(creature(2 * round + 1));
+        std::this_thread::sleep_for(std::chrono::microseconds(round % 3 == 0 ? 200 : 0));
+        cmm.enqueue(creature(2 * round + 2));
+        cmm.drain();
+        ASSERT_EQ(cmm.matches(), round + 1u);
+    }
+    EXPECT_EQ(cmm.pending(), 0u);
+    EXPECT_EQ(ledger.results().size(), 200u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
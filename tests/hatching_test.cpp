@@ -32,6 +32,44 @@ TEST(HatchingTest, WeightGeneration) {
     EXPECT_EQ(w[4], -8);
 }
 
+TEST(HatchingTest, CounterWeightsMatchSequentialStream) {
+    for (std::uint64_t seed : {0ull, 42ull, 0xFFFFFFFFFFFFFFFFull}) {
+        std::uint64_t state = seed;
+        auto w = neuropet::generate_genesis_weights(1000, seed);
+        for (std::size_t i = 0; i < w.size(); ++i)
+            ASSERT_EQ(w[i], neuropet::next_weight(state)) << "seed " << seed << " index " << i;
+        std::vector<int8_t> tail(100);
+        neuropet::generate_genesis_weights(tail.data(), tail.size(), seed, 900);
+        EXPECT_EQ(tail, std::vector<int8_t>(w.begin() + 900, w.end()));
+    }
+}
+
+TEST(HatchingTest, BatchMatchesPerCreatureHatch) {
+    std::vector<neuropet::HatchRequest> requests(600);
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        for (std::size_t j = 0; j < 32; ++j)
+            requests[i].seed[j] = static_cast<uint8_t>(i * 31 + j * 7);
+        requests[i].weight_seed = i * 0x1234567ull;
+        requests[i].weight_count = i % 5 == 0 ? 5000 : i % 300;
+    }
+    auto one = neuropet::hatch_batch(requests, 1);
+    auto many = neuropet::hatch_batch(requests, 4, 1024);
+    ASSERT_EQ(one.size(), requests.size());
+    ASSERT_EQ(many.size(), requests.size());
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        auto topo = neuropet::derive_topology(requests[i].seed);
+        auto w = neuropet::generate_genesis_weights(requests[i].weight_count,
+                                                    requests[i].weight_seed);
+        for (const auto* r : {&one[i], &many[i]}) {
+            EXPECT_EQ(r->topology.sensor_count, topo.sensor_count);
+            EXPECT_EQ(r->topology.append_count, topo.append_count);
+            EXPECT_EQ(r->topology.sensor_size, topo.sensor_size);
+            EXPECT_EQ(r->topology.append_size, topo.append_size);
+            EXPECT_EQ(r->weights, w);
+        }
+    }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
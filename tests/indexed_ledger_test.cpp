@@ -0,0 +1,59 @@
+#include "neuropet/indexed_ledger.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+TEST(IndexedLedgerTest, TracksCountersAndHistory) {
+    neuropet::IndexedLedger ledger;
+    ledger.record_result(1, 2);
+    ledger.record_result(1, 3);
+    ledger.record_result(2, 1);
+    ledger.record_result(1, 2);
+    const auto* one = ledger.creature(1);
+    ASSERT_NE(one, nullptr);
+    EXPECT_EQ(one->wins, 3u);
+    EXPECT_EQ(one->losses, 1u);
+    EXPECT_EQ(one->results, (std::vector<std::uint32_t>{0, 1, 2, 3}));
+    EXPECT_EQ(ledger.creature(3)->results, (std::vector<std::uint32_t>{1}));
+    EXPECT_EQ(ledger.creature(4), nullptr);
+    EXPECT_EQ(ledger.head_to_head(1, 2), std::make_pair(2u, 1u));
+    EXPECT_EQ(ledger.head_to_head(3, 1), std::make_pair(0u, 1u));
+    EXPECT_EQ(ledger.index().creatures(), 3u);
+}
+
+TEST(IndexedLedgerTest, RatingsAndLeaderboardMatchFullReplay) {
+    neuropet::IndexedLedger ledger;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<std::uint32_t> id(1, 300);
+    for (int i = 0; i < 5000; ++i) {
+        std::uint32_t w = id(rng);
+        std::uint32_t l = id(rng);
+        if (w != l)
+            ledger.record_result(w, l);
+    }
+    neuropet::EloRatings elo;
+    elo.sync(ledger);
+    std::vector<neuropet::LeaderboardEntry> expected;
+    for (std::uint32_t c = 1; c <= 300; ++c) {
+        if (!ledger.creature(c))
+            continue;
+        EXPECT_DOUBLE_EQ(ledger.creature(c)->rating, elo.rating(c));
+        expected.push_back({c, elo.rating(c)});
+    }
+    std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+        return a.rating != b.rating ? a.rating > b.rating : a.id < b.id;
+    });
+    auto top = ledger.top(10);
+    ASSERT_EQ(top.size(), 10u);
+    for (std::size_t i = 0; i < top.size(); ++i) {
+        EXPECT_EQ(top[i].id, expected[i].id);
+        EXPECT_DOUBLE_EQ(top[i].rating, expected[i].rating);
+    }
+    EXPECT_EQ(ledger.top(1000).size(), expected.size());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+#include "neuropet/mapped_ledger.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string temp_ledger(const char* name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+class FailingSyncLedger : public neuropet::MappedMatchLedger {
+  public:
+    using MappedMatchLedger::MappedMatchLedger;
+    bool fail{false};
+
+  protected:
+    bool sync_pages(unsigned char* addr, std::size_t len) override {
+        return !fail && MappedMatchLedger::sync_pages(addr, len);
+    }
+};
+} // namespace
+
+TEST(MappedLedgerTest, PersistsAndRebuildsIndexes) {
+    auto path = temp_ledger("neuropet_mapped_ledger_persist.log");
+    {
+        neuropet::MappedMatchLedger ledger(path, 4);
+        for (std::uint32_t i = 0; i < 10; ++i)
+            EXPECT_EQ(ledger.record_result(1 + i % 3, 10 + i), i + 1);
+        EXPECT_GE(ledger.capacity(), 10u);
+    }
+    neuropet::MappedMatchLedger reopened(path);
+    ASSERT_EQ(reopened.results().size(), 10u);
+    EXPECT_EQ(reopened.truncated(), 0u);
+    EXPECT_EQ(reopened.results()[9].winner, 1u);
+    EXPECT_EQ(reopened.results()[9].loser, 19u);
+    ASSERT_NE(reopened.index().find(1), nullptr);
+    EXPECT_EQ(reopened.index().find(1)->wins, 4u);
+    EXPECT_EQ(reopened.index().find(1)->results, (std::vector<std::uint32_t>{0, 3, 6, 9}));
+    EXPECT_EQ(reopened.record_result(5, 6), 11u);
+    std::filesystem::remove(path);
+}
+
+TEST(MappedLedgerTest, TruncatesTornTail) {
+    auto path = temp_ledger("neuropet_mapped_ledger_torn.log");
+    {
+        neuropet::MappedMatchLedger ledger(path, 16);
+        for (std::uint32_t i = 0; i < 5; ++i)
+            ledger.record_result(100 + i, 200 + i);
+        ledger.flush();
+    }
+    {
+        // Corrupt the loser field of the last record as a torn write would.
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(neuropet::MappedMatchLedger::HEADER_SIZE +
+                4 * neuropet::MappedMatchLedger::RECORD_SIZE + 8);
+        f.put('\x7f');
+    }
+    {
+        neuropet::MappedMatchLedger ledger(path);
+        EXPECT_EQ(ledger.results().size(), 4u);
+        EXPECT_EQ(ledger.truncated(), 1u);
+        EXPECT_EQ(ledger.record_result(7, 8), 5u);
+    }
+    neuropet::MappedMatchLedger ledger(path);
+    ASSERT_EQ(ledger.results().size(), 5u);
+    EXPECT_EQ(ledger.results()[4].winner, 7u);
+    EXPECT_EQ(ledger.truncated(), 0u);
+    std::filesystem::remove(path);
+}
+
+TEST(MappedLedgerTest, DropsStaleRecordsAfterTornOne) {
+    auto path = temp_ledger("neuropet_mapped_ledger_stale.log");
+    {
+        neuropet::MappedMatchLedger ledger(path, 16);
+        for (std::uint32_t i = 0; i < 6; ++i)
+            ledger.record_result(100 + i, 200 + i);
+        ledger.flush();
+    }
+    {
+        // Record 3 never reached the disk but records 4 to 6 did.
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(neuropet::MappedMatchLedger::HEADER_SIZE +
+                2 * neuropet::MappedMatchLedger::RECORD_SIZE);
+        for (std::size_t i = 0; i < neuropet::MappedMatchLedger::RECORD_SIZE; ++i)
+            f.put('\0');
+    }
+    {
+        neuropet::MappedMatchLedger ledger(path);
+        EXPECT_EQ(ledger.results().size(), 2u);
+        EXPECT_EQ(ledger.truncated(), 3u);
+        EXPECT_EQ(ledger.record_result(7, 8), 3u);
+    }
+    neuropet::MappedMatchLedger ledger(path);
+    ASSERT_EQ(ledger.results().size(), 3u);
+    EXPECT_EQ(ledger.results()[2].winner, 7u);
+    EXPECT_EQ(ledger.truncated(), 0u);
+    std::filesystem::remove(path);
+}
+
+TEST(MappedLedgerTest, SyncsEveryInterval) {
+    auto path = temp_ledger("neuropet_mapped_ledger_interval.log");
+    {
+        neuropet::MappedMatchLedger ledger(path, 4, 3);
+        for (std::uint32_t i = 0; i < 1000; ++i)
+            ledger.record_result(1 + i, 2 + i);
+    }
+    neuropet::MappedMatchLedger ledger(path);
+    EXPECT_EQ(ledger.results().size(), 1000u);
+    std::filesystem::remove(path);
+}
+
+TEST(MappedLedgerTest, FailedSyncKeepsStateConsistent) {
+    auto path = temp_ledger("neuropet_mapped_ledger_sync_fail.log");
+    {
+        FailingSyncLedger ledger(path, 4, 2);
+        EXPECT_EQ(ledger.record_result(1, 2), 1u);
+        ledger.fail = true;
+        // The interval sync fails after the record was appended.
+        EXPECT_THROW(ledger.record_result(3, 4), std::runtime_error);
+        ASSERT_EQ(ledger.results().size(), 2u);
+        EXPECT_EQ(ledger.results()[1].battle_id, 2u);
+        EXPECT_EQ(ledger.index().find(3)->wins, 1u);
+        EXPECT_THROW(ledger.record_result(5, 6), std::runtime_error);
+        EXPECT_THROW(ledger.flush(), std::runtime_error);
+        // Growing the full file fails before anything is written.
+        EXPECT_THROW(ledger.record_result(7, 8), std::runtime_error);
+        EXPECT_EQ(ledger.results().size(), 4u);
+        EXPECT_EQ(ledger.capacity(), 4u);
+        ledger.fail = false;
+        EXPECT_EQ(ledger.record_result(9, 10), 5u);
+        ledger.flush();
+    }
+    neuropet::MappedMatchLedger ledger(path);
+    ASSERT_EQ(ledger.results().size(), 5u);
+    EXPECT_EQ(ledger.truncated(), 0u);
+    for (std::uint32_t i = 0; i < 5; ++i)
+        EXPECT_EQ(ledger.results()[i].battle_id, i + 1);
+    EXPECT_EQ(ledger.results()[4].winner, 9u);
+    std::filesystem::remove(path);
+}
+
+TEST(MappedLedgerTest, RejectsForeignFiles) {
+    auto path = temp_ledger("neuropet_mapped_ledger_bad.log");
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << "definitely not a ledger file";
+    }
+    EXPECT_THROW(neuropet::MappedMatchLedger{path}, std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,8 @@
 #include "neuropet/battle.hpp"
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 TEST(MatchmakerTest, RunsAndRecords) {
     neuropet::BattleEngine engine;
     neuropet::MatchLedger ledger;
@@ -15,6 +17,23 @@ TEST(MatchmakerTest, RunsAndRecords) {
     EXPECT_EQ(ledger.results()[0].winner, *winner);
 }
 
+TEST(MatchmakerTest, DrainsLargeQueueInFifoOrder) {
+    neuropet::MatchLedger ledger;
+    neuropet::Matchmaker mm(neuropet::BattleEngine{}, &ledger);
+    for (std::uint32_t id = 1; id <= 10000; ++id)
+        mm.enqueue(neuropet::CompactCreature{id, 1, 1, 1});
+    EXPECT_EQ(mm.pending(), 10000u);
+    while (mm.try_match())
+        ;
+    EXPECT_EQ(mm.pending(), 0u);
+    ASSERT_EQ(ledger.results().size(), 5000u);
+    for (std::uint32_t i = 0; i < 5000; ++i) {
+        const auto& r = ledger.results()[i];
+        EXPECT_EQ(std::min(r.winner, r.loser), 2 * i + 1);
+        EXPECT_EQ(std::max(r.winner, r.loser), 2 * i + 2);
+    }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,108 @@
+#include "neuropet/metrics.hpp"
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(MetricsStreamerTest, RingIsFifoAndBounded) {
+    neuropet::MpmcRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(ring.try_push(i));
+    EXPECT_FALSE(ring.try_push(4));
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(ring.try_pop(v));
+}
+
+TEST(MetricsStreamerTest, BatchesRecordsIntoFrames) {
+    std::mutex m;
+    std::vector<neuropet::TrainingMetrics> received;
+    std::size_t frames = 0;
+    neuropet::MetricsStreamerOptions opts;
+    opts.interval = std::chrono::milliseconds(1000);
+    opts.max_batch = 64;
+    neuropet::MetricsStreamer streamer(
+        [&](const harmonics::HTensor& t) {
+            std::lock_guard<std::mutex> lk(m);
+            ASSERT_EQ(t.shape().size(), 2u);
+            ASSERT_EQ(t.shape()[1], 2u);
+            const float* d = reinterpret_cast<const float*>(t.data().data());
+            for (std::size_t i = 0; i < t.shape()[0]; ++i)
+                received.push_back({static_cast<std::uint32_t>(d[2 * i]), d[2 * i + 1]});
+            ++frames;
+        },
+        opts);
+    for (std::uint32_t i = 0; i < 200; ++i)
+        streamer.push({i, 0.5f * i});
+    streamer.flush();
+    EXPECT_EQ(streamer.sent(), 200u);
+    EXPECT_EQ(streamer.dropped(), 0u);
+    EXPECT_EQ(streamer.frames(), 4u);
+    std::lock_guard<std::mutex> lk(m);
+    EXPECT_EQ(frames, 4u);
+    ASSERT_EQ(received.size(), 200u);
+    for (std::uint32_t i = 0; i < 200; ++i) {
+        EXPECT_EQ(received[i].step, i);
+        EXPECT_FLOAT_EQ(received[i].loss, 0.5f * i);
+    }
+}
+
+TEST(MetricsStreamerTest, DropsOldestWhenFull) {
+    std::vector<std::uint32_t> steps;
+    neuropet::MetricsStreamerOptions opts;
+    opts.capacity = 8;
+    opts.interval = std::chrono::milliseconds(10000);
+    neuropet::MetricsStreamer streamer(
+        [&](const harmonics::HTensor& t) {
+            const float* d = reinterpret_cast<const float*>(t.data().data());
+            for (std::size_t i = 0; i < t.shape()[0]; ++i)
+                steps.push_back(static_cast<std::uint32_t>(d[2 * i]));
+        },
+        opts);
+    for (std::uint32_t i = 0; i < 20; ++i)
+        streamer.push({i, 0.0f});
+    streamer.flush();
+    EXPECT_EQ(streamer.dropped(), 12u);
+    EXPECT_EQ(streamer.sent(), 8u);
+    ASSERT_EQ(steps.size(), 8u);
+    for (std::uint32_t i = 0; i < 8; ++i)
+        EXPECT_EQ(steps[i], 12 + i);
+}
+
+TEST(MetricsStreamerTest, ConcurrentProducersAccountForEveryRecord) {
+    std::atomic<std::uint64_t> rows{0};
+    neuropet::MetricsStreamerOptions opts;
+    opts.capacity = 64;
+    opts.interval = std::chrono::milliseconds(1);
+    neuropet::MetricsStreamer streamer(
+        [&](const harmonics::HTensor& t) { rows += t.shape()[0]; }, opts);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p)
+        producers.emplace_back([&]() {
+            for (std::uint32_t i = 0; i < 1000; ++i)
+                streamer.push({i, 1.0f});
+        });
+    for (auto& t : producers)
+        t.join();
+    streamer.flush();
+    EXPECT_EQ(streamer.sent() + streamer.dropped(), 4000u);
+    EXPECT_EQ(rows.load(), streamer.sent());
+}
+
+TEST(MetricsStreamerTest, FlushReportsSinkErrors) {
+    neuropet::MetricsStreamer streamer(
+        [](const harmonics::HTensor&) { throw std::runtime_error("offline"); });
+    streamer.push({1, 1.0f});
+    EXPECT_THROW(streamer.flush(), std::runtime_error);
+    EXPECT_EQ(streamer.dropped(), 1u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
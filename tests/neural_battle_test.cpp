@@ -0,0 +1,137 @@
+#include "neuropet/neural_battle.hpp"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace neuropet;
+
+namespace {
+
+/** Appendage that walks toward the opponent and attacks once adjacent. */
+CreatureModel charger() {
+    Int8Layer l{Int8Op::Dense, kNeuralSensorInputs, 6, std::vector<int8_t>(kNeuralSensorInputs * 6, 0),
+                std::vector<int8_t>(6, 0)};
+    auto w = [&](std::size_t in, NeuralAction a, int v) {
+        l.weights[in * 6 + static_cast<std::size_t>(a)] = static_cast<int8_t>(v);
+    };
+    w(1, NeuralAction::MoveEast, 30);
+    w(1, NeuralAction::MoveWest, -30);
+    w(2, NeuralAction::MoveSouth, 30);
+    w(2, NeuralAction::MoveNorth, -30);
+    w(3, NeuralAction::Attack, 50);
+    CreatureModel m;
+    m.appendage.layers.push_back(l);
+    return m;
+}
+
+/** Appendage whose bias always selects ``action``. */
+CreatureModel constant(NeuralAction action) {
+    Int8Layer l{Int8Op::Dense, kNeuralSensorInputs, 6, std::vector<int8_t>(kNeuralSensorInputs * 6, 0),
+                std::vector<int8_t>(6, 0)};
+    l.bias[static_cast<std::size_t>(action)] = 1;
+    CreatureModel m;
+    m.appendage.layers.push_back(l);
+    return m;
+}
+
+} // namespace
+
+TEST(NeuralBattleTest, BatchedInferenceMatchesPerRow) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> v(-128, 127);
+    Int8Network net;
+    Int8Layer dense{Int8Op::Dense, 4, 3, {}, {}};
+    for (int i = 0; i < 12; ++i)
+        dense.weights.push_back(static_cast<int8_t>(v(rng)));
+    for (int i = 0; i < 3; ++i)
+        dense.bias.push_back(static_cast<int8_t>(v(rng)));
+    net.layers.push_back(dense);
+    net.layers.push_back({Int8Op::ReLU, 3, 3, {}, {}});
+
+    const std::size_t rows = 9;
+    std::vector<int8_t> input;
+    for (std::size_t i = 0; i < rows * 4; ++i)
+        input.push_back(static_cast<int8_t>(v(rng)));
+    auto batched = eval_network_batch(net, input, rows);
+    ASSERT_EQ(batched.size(), rows * 3);
+    for (std::size_t r = 0; r < rows; ++r) {
+        std::vector<int8_t> row(input.begin() + r * 4, input.begin() + (r + 1) * 4);
+        auto single = eval_network(net, row);
+        EXPECT_EQ(std::vector<int8_t>(batched.begin() + r * 3, batched.begin() + (r + 1) * 3),
+                  single);
+    }
+    EXPECT_THROW(eval_network_batch(net, input, rows + 1), std::runtime_error);
+}
+
+TEST(NeuralBattleTest, ChargerReproducesScriptedFight) {
+    CreatureModel model = charger();
+    BattleEngine board;
+    NeuralBattleEngine engine(board);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> stat(1, 10);
+    for (int i = 0; i < 200; ++i) {
+        CreatureStats a{static_cast<std::uint32_t>(2 * i + 1), stat(rng), stat(rng), 10};
+        CreatureStats b{static_cast<std::uint32_t>(2 * i + 2), stat(rng), stat(rng), 10};
+        std::uint32_t seed = static_cast<std::uint32_t>(i);
+        EXPECT_EQ(engine.fight(a, model, b, model, seed), board.fight(a, b, seed));
+    }
+}
+
+TEST(NeuralBattleTest, BatchMatchesIndividualFightsAndSharesInference) {
+    CreatureModel chase = charger();
+    CreatureModel guard = constant(NeuralAction::Block);
+    BattleEngine board;
+    board.set_tile(3, 3, BattleEngine::Tile::WALL);
+    board.set_tile(4, 0, BattleEngine::Tile::HAZARD);
+    NeuralBattleEngine engine(board, 64);
+
+    std::vector<CreatureStats> creatures;
+    for (std::uint32_t i = 0; i < 40; ++i)
+        creatures.push_back({i + 1, 1 + static_cast<int>(i % 7), 2 + static_cast<int>(i % 5),
+                             1 + static_cast<int>(i % 9)});
+    std::vector<NeuralMatch> matches;
+    for (std::size_t i = 0; i + 1 < creatures.size(); i += 2)
+        matches.push_back({&creatures[i], &chase, &creatures[i + 1], i % 4 ? &chase : &guard,
+                           static_cast<std::uint32_t>(i)});
+
+    auto res = engine.fight_batch(matches);
+    ASSERT_EQ(res.winners.size(), matches.size());
+    std::uint32_t longest = 0;
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        const NeuralMatch& m = matches[i];
+        EXPECT_EQ(res.winners[i], engine.fight(*m.a, *m.model_a, *m.b, *m.model_b, m.seed));
+        longest = std::max(longest, res.turns[i]);
+    }
+    // At most one call per distinct model per turn.
+    EXPECT_LE(res.inference_calls, 2u * longest);
+    EXPECT_GE(res.inference_calls, longest);
+}
+
+TEST(NeuralBattleTest, TurnLimitEndsPassiveBattles) {
+    CreatureModel idle = constant(NeuralAction::Block);
+    CreatureStats a{1, 5, 4, 3};
+    CreatureStats b{2, 5, 6, 3};
+    NeuralBattleEngine engine(BattleEngine{}, 10);
+    auto res = engine.fight_batch({{&a, &idle, &b, &idle, 1}});
+    EXPECT_EQ(res.turns[0], 10u);
+    EXPECT_EQ(res.inference_calls, 10u);
+    EXPECT_EQ(res.winners[0], 2u);
+}
+
+TEST(NeuralBattleTest, RejectsIncompleteMatchesAndBadModels) {
+    CreatureModel model = charger();
+    CreatureStats a{1, 1, 1, 1};
+    NeuralBattleEngine engine;
+    EXPECT_THROW(engine.fight_batch({{&a, &model, nullptr, &model, 0}}), std::runtime_error);
+
+    CreatureModel wrong;
+    wrong.appendage.layers.push_back({Int8Op::Dense, 2, 6, std::vector<int8_t>(12, 0),
+                                      std::vector<int8_t>(6, 0)});
+    CreatureStats b{2, 1, 1, 1};
+    EXPECT_THROW(engine.fight(a, wrong, b, wrong), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -4,7 +4,9 @@
 #include <cstdlib>
 #include <filesystem>
 #include <gtest/gtest.h>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #ifdef __unix__
 TEST(ValidatorTest, BroadcastAndIngest) {
@@ -31,6 +33,73 @@ TEST(ValidatorTest, BroadcastAndIngest) {
     a.stop();
     b.stop();
 }
+
+TEST(ValidatorTest, BinaryRootsOnTheWire) {
+    neuropet::ProofAggregatorServer a(0);
+    neuropet::ProofAggregatorServer b(0);
+    a.start();
+    b.start();
+    ASSERT_TRUE(a.connect("127.0.0.1", b.port()));
+
+    neuropet::Validator va(1, neuropet::Blake3ProofSystem::instance(), &a);
+    neuropet::Validator vb(1, neuropet::Blake3ProofSystem::instance(), &b);
+    auto proof = va.generate_stark_proof({{4, 5, 6}});
+
+    for (int i = 0; i < 50 && !vb.has_quorum(proof.root); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(vb.has_quorum(proof.root_digest()));
+    EXPECT_GE(b.stats().proofs_received.load(), 1u);
+    a.stop();
+    b.stop();
+}
+
+TEST(ValidatorTest, QuorumCountsDistinctPeers) {
+    // Three provers each reach the observer over their own connection.
+    neuropet::ProofAggregatorServer observer(0);
+    observer.start();
+    std::vector<std::unique_ptr<neuropet::ProofAggregatorServer>> provers;
+    std::vector<std::unique_ptr<neuropet::Validator>> validators;
+    for (int i = 0; i < 3; ++i) {
+        provers.push_back(std::make_unique<neuropet::ProofAggregatorServer>(0));
+        provers.back()->start();
+        ASSERT_TRUE(provers.back()->connect("127.0.0.1", observer.port()));
+        validators.push_back(std::make_unique<neuropet::Validator>(
+            3, neuropet::Blake3ProofSystem::instance(), provers.back().get()));
+    }
+    neuropet::Validator vo(3, neuropet::Blake3ProofSystem::instance(), &observer);
+
+    auto proof = validators[0]->generate_stark_proof({{7, 8, 9}});
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(vo.has_quorum(proof.root_digest()));
+
+    validators[1]->generate_stark_proof({{7, 8, 9}});
+    validators[2]->generate_stark_proof({{7, 8, 9}});
+    for (int i = 0; i < 50 && !vo.has_quorum(proof.root_digest()); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(vo.has_quorum(proof.root_digest()));
+
+    // Known proofs are not relayed again, so the echoes die out.
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto received = observer.stats().proofs_received.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(observer.stats().proofs_received.load(), received);
+    for (auto& p : provers)
+        p->stop();
+    observer.stop();
+}
+
+TEST(ValidatorTest, SenderTrackingIsBounded) {
+    neuropet::ProofAggregatorServer a(0, 4);
+    std::size_t reported = 0;
+    a.set_callback([&](const neuropet::StarkProof&) { ++reported; });
+    for (int8_t i = 0; i < 10; ++i)
+        a.submit(neuropet::Blake3ProofSystem::instance().generate_proof({{i}}));
+    EXPECT_EQ(reported, 10u);
+    EXPECT_EQ(a.tracked_roots(), 4u);
+    // The newest roots are still remembered.
+    a.submit(neuropet::Blake3ProofSystem::instance().generate_proof({{9}}));
+    EXPECT_EQ(reported, 10u);
+}
 #endif
 
 int main(int argc, char** argv) {
@@ -1,6 +1,8 @@
 #include "neuropet/pouw_chain.hpp"
 #include <gtest/gtest.h>
 
+#include <unordered_set>
+
 TEST(PoUWChainTest, RewardsAfterFinalization) {
     neuropet::PoUWChain chain(2, neuropet::Blake3ProofSystem::instance());
     chain.submit_checkpoint(1, 0, "dead", "miner", 1.0f, 5);
@@ -44,6 +46,48 @@ TEST(PoUWChainTest, RejectLossIncrease) {
     EXPECT_EQ(chain.finalize_checkpoint("r1"), false);
 }
 
+TEST(PoUWChainTest, Digest32RoundTrip) {
+    std::string hex(64, 'a');
+    hex[1] = '7';
+    auto d = neuropet::Digest32::from_hex(hex);
+    EXPECT_EQ(d.bytes[0], 0xa7);
+    EXPECT_EQ(d.hex(), hex);
+    std::string upper = hex;
+    upper[0] = 'A';
+    EXPECT_EQ(neuropet::Digest32::from_root(upper), d);
+    EXPECT_THROW(neuropet::Digest32::from_hex("dead"), std::runtime_error);
+    EXPECT_THROW(neuropet::Digest32::from_hex(std::string(64, 'g')), std::runtime_error);
+    EXPECT_EQ(neuropet::Digest32::from_root("dead"), neuropet::Digest32::from_root("dead"));
+    EXPECT_NE(neuropet::Digest32::from_root("dead"), neuropet::Digest32::from_root("beef"));
+}
+
+TEST(PoUWChainTest, Digest32HashMixesEveryByte) {
+    // Roots sharing their first eight bytes must not share a bucket.
+    neuropet::Digest32Hash hash;
+    std::unordered_set<std::size_t> seen;
+    for (std::uint8_t i = 0; i < 64; ++i) {
+        neuropet::Digest32 d;
+        d.bytes[8 + i % 24] = static_cast<std::uint8_t>(1 + i / 24);
+        EXPECT_EQ(hash(d), hash(neuropet::Digest32::from_bytes(d.bytes.data())));
+        seen.insert(hash(d));
+    }
+    EXPECT_EQ(seen.size(), 64u);
+}
+
+TEST(PoUWChainTest, DigestAndHexRootsAreInterchangeable) {
+    neuropet::PoUWChain chain(2, neuropet::Blake3ProofSystem::instance());
+    auto proof = neuropet::Blake3ProofSystem::instance().generate_proof({{1, 2, 3}});
+    auto root = proof.root_digest();
+    chain.submit_checkpoint(1, 0, proof.root, "miner", 1.0f, 2);
+    chain.attest(root);
+    chain.attest(proof.root);
+    EXPECT_EQ(chain.finalize_checkpoint(root), true);
+    ASSERT_EQ(chain.chain().size(), 1u);
+    EXPECT_EQ(chain.chain()[0].root, root);
+    EXPECT_EQ(chain.chain()[0].root_hash, proof.root);
+    EXPECT_EQ(chain.finalize_checkpoint(proof.root), false);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
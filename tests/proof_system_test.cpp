@@ -1,3 +1,4 @@
+#include "neuropet/merkle_proof.hpp"
 #include "neuropet/validator.hpp"
 #include <cmath>
 #include <gtest/gtest.h>
@@ -56,6 +57,172 @@ TEST(ProofSystemTest, RejectsTamperedProof) {
     EXPECT_EQ(v.verify_stark_proof(tensors, bad), false);
 }
 
+TEST(ProofSystemTest, ViewsMatchVectors) {
+    const auto& sys = neuropet::Blake3ProofSystem::instance();
+    std::vector<int8_t> weights(65536);
+    for (std::size_t i = 0; i < weights.size(); ++i)
+        weights[i] = static_cast<int8_t>(i * 7);
+    std::vector<int8_t> target{1, 0, 0, 0, 3, 1};
+    std::vector<std::vector<int8_t>> tensors{weights, target};
+    neuropet::TensorView views[2] = {{weights.data(), weights.size()},
+                                     {target.data(), target.size()}};
+
+    auto a = sys.generate_proof(tensors);
+    auto b = sys.generate_proof(views, 2);
+    EXPECT_EQ(a.root, b.root);
+    EXPECT_EQ(a.proof, b.proof);
+    EXPECT_EQ(a.loss, b.loss);
+    EXPECT_EQ(neuropet::compute_loss(views, 2), neuropet::compute_loss(tensors));
+    EXPECT_EQ(sys.verify_proof(views, 2, a), true);
+
+    neuropet::Validator v(3, sys);
+    EXPECT_EQ(v.verify_stark_proof(views, 2, v.generate_stark_proof(views, 2)), true);
+}
+
+namespace {
+/** Implements only the vector interface to exercise the default view overloads. */
+class VectorOnlyProofSystem : public neuropet::IProofSystem {
+  public:
+    using neuropet::IProofSystem::generate_proof;
+    using neuropet::IProofSystem::verify_proof;
+
+    neuropet::StarkProof
+    generate_proof(const std::vector<std::vector<int8_t>>& tensors) const override {
+        return neuropet::Blake3ProofSystem::instance().generate_proof(tensors);
+    }
+    bool verify_proof(const std::vector<std::vector<int8_t>>& tensors,
+                      const neuropet::StarkProof& proof) const override {
+        return neuropet::Blake3ProofSystem::instance().verify_proof(tensors, proof);
+    }
+};
+} // namespace
+
+TEST(ProofSystemTest, DefaultViewOverloadsCopy) {
+    VectorOnlyProofSystem sys;
+    std::vector<int8_t> t{1, 2, 3};
+    neuropet::TensorView view{t.data(), t.size()};
+    auto proof = sys.generate_proof(&view, 1);
+    EXPECT_EQ(proof.root, neuropet::Blake3ProofSystem::instance().generate_proof({t}).root);
+    EXPECT_EQ(sys.verify_proof(&view, 1, proof), true);
+}
+
+namespace {
+std::vector<std::vector<int8_t>> merkle_tensors() {
+    std::vector<std::vector<int8_t>> tensors{{2, 1, 0, 0, 3, 2}, {1, 0, 0, 0, 3, 1}, {}};
+    for (std::size_t n : {4096u, 10000u, 1u, 3000u}) {
+        std::vector<int8_t> t(n);
+        for (std::size_t i = 0; i < n; ++i)
+            t[i] = static_cast<int8_t>(i * 31 + n);
+        tensors.push_back(t);
+    }
+    return tensors;
+}
+} // namespace
+
+TEST(ProofSystemTest, MerkleRootIndependentOfThreads) {
+    auto tensors = merkle_tensors();
+    neuropet::MerkleProofSystem serial(1024, 1);
+    neuropet::MerkleProofSystem parallel(1024, 4);
+    auto proof = serial.generate_proof(tensors);
+    EXPECT_EQ(proof.root.size(), 64u);
+    EXPECT_EQ(parallel.generate_proof(tensors).root, proof.root);
+    EXPECT_EQ(proof.loss, neuropet::compute_loss(tensors));
+    EXPECT_NE(neuropet::MerkleProofSystem(512, 1).generate_proof(tensors).root, proof.root);
+
+    neuropet::Validator v(3, parallel);
+    EXPECT_EQ(v.verify_stark_proof(tensors, proof), true);
+    tensors[4][5000] ^= 1;
+    EXPECT_EQ(v.verify_stark_proof(tensors, proof), false);
+}
+
+TEST(ProofSystemTest, MerkleCheckpointRehashesTouchedChunks) {
+    auto tensors = merkle_tensors();
+    neuropet::MerkleProofSystem system(1024, 2);
+    neuropet::MerkleCheckpoint ckpt(1024, 2);
+    ckpt.assign(tensors);
+    EXPECT_EQ(ckpt.proof().root, system.generate_proof(tensors).root);
+
+    tensors[4][5000] ^= 1;
+    tensors[4][5001] ^= 1;
+    tensors[3][7] = 9;
+    ckpt.touch(4, 5000, 2);
+    ckpt.touch(3);
+    auto proof = ckpt.proof();
+    EXPECT_EQ(proof.root, system.generate_proof(tensors).root);
+    EXPECT_EQ(system.verify_proof(tensors, proof), true);
+
+    // Changes that are not reported keep the cached hashes.
+    tensors[6][0] ^= 1;
+    EXPECT_EQ(ckpt.proof().root, proof.root);
+    ckpt.touch(6, 0, 1);
+    EXPECT_EQ(ckpt.proof().root, system.generate_proof(tensors).root);
+
+    tensors[2].assign(2500, 4);
+    ckpt.set_tensor(2, {tensors[2].data(), tensors[2].size()});
+    EXPECT_EQ(ckpt.proof().root, system.generate_proof(tensors).root);
+
+    EXPECT_THROW(ckpt.touch(4, 9999, 2), std::runtime_error);
+    EXPECT_THROW(ckpt.touch(tensors.size()), std::runtime_error);
+}
+
+TEST(ProofSystemTest, MerkleCheckpointShrinkDropsPendingChunks) {
+    std::vector<std::vector<int8_t>> tensors{std::vector<int8_t>(100, 1), {2, 3}};
+    neuropet::MerkleProofSystem system(10);
+    neuropet::MerkleCheckpoint ckpt(10);
+    ckpt.assign(tensors);
+    tensors[0][95] = 7;
+    ckpt.touch(0, 95, 1);
+    tensors[0].assign(20, 5);
+    ckpt.set_tensor(0, {tensors[0].data(), tensors[0].size()});
+    EXPECT_EQ(ckpt.proof().root, system.generate_proof(tensors).root);
+    auto views = neuropet::tensor_views(tensors);
+    EXPECT_EQ(ckpt.layer_proof(0).siblings, system.layer_proof(views.data(), 2, 0).siblings);
+}
+
+TEST(ProofSystemTest, MerkleLayerInclusionProofs) {
+    auto all = merkle_tensors();
+    neuropet::MerkleProofSystem system(1024);
+    for (std::size_t count = 1; count <= all.size(); ++count) {
+        std::vector<std::vector<int8_t>> tensors(all.begin(), all.begin() + count);
+        auto views = neuropet::tensor_views(tensors);
+        neuropet::MerkleCheckpoint ckpt(1024);
+        ckpt.assign(tensors);
+        auto root = neuropet::Digest32::from_hex(system.generate_proof(tensors).root);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto proof = system.layer_proof(views.data(), count, i);
+            EXPECT_EQ(system.verify_layer(root, views[i], proof), true);
+            EXPECT_EQ(ckpt.layer_proof(i).siblings, proof.siblings);
+            if (count > 1) {
+                auto wrong = proof;
+                wrong.index = (i + 1) % count;
+                EXPECT_EQ(system.verify_layer(root, views[i], wrong), false);
+                wrong = proof;
+                wrong.siblings[0].bytes[0] ^= 1;
+                EXPECT_EQ(system.verify_layer(root, views[i], wrong), false);
+                wrong = proof;
+                wrong.siblings.pop_back();
+                EXPECT_EQ(system.verify_layer(root, views[i], wrong), false);
+            }
+        }
+    }
+
+    // In a three-layer tree the last leaf's path folds to the same tree root
+    // as index 1 of a two-layer tree; the layer count in the root rejects it.
+    std::vector<std::vector<int8_t>> three(all.begin(), all.begin() + 3);
+    auto views = neuropet::tensor_views(three);
+    auto root = neuropet::Digest32::from_hex(system.generate_proof(three).root);
+    auto proof = system.layer_proof(views.data(), 3, 2);
+    ASSERT_EQ(proof.siblings.size(), 1u);
+    EXPECT_EQ(system.verify_layer(root, views[2], proof), true);
+    auto forged = proof;
+    forged.index = 1;
+    forged.layers = 2;
+    EXPECT_EQ(system.verify_layer(root, views[2], forged), false);
+    forged = proof;
+    forged.layers = 4;
+    EXPECT_EQ(system.verify_layer(root, views[2], forged), false);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,57 @@
+#include "neuropet/simulation.hpp"
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<neuropet::MatchResult> simulate(std::uint64_t seed, unsigned threads) {
+    neuropet::MatchLedger ledger;
+    neuropet::run_simulation(12, 1, 3000, ledger, seed, threads);
+    return ledger.results();
+}
+
+bool same(const std::vector<neuropet::MatchResult>& a,
+          const std::vector<neuropet::MatchResult>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        if (a[i].battle_id != b[i].battle_id || a[i].winner != b[i].winner ||
+            a[i].loser != b[i].loser)
+            return false;
+    return true;
+}
+} // namespace
+
+TEST(SimulationTest, ParallelOutputIndependentOfThreadCount) {
+    auto serial = simulate(42, 1);
+    ASSERT_EQ(serial.size(), 3000u);
+    for (const auto& r : serial) {
+        EXPECT_NE(r.winner, r.loser);
+        EXPECT_GE(r.winner, 1u);
+        EXPECT_LE(r.winner, 12u);
+    }
+    EXPECT_TRUE(same(serial, simulate(42, 2)));
+    EXPECT_TRUE(same(serial, simulate(42, 5)));
+    EXPECT_FALSE(same(serial, simulate(43, 2)));
+}
+
+TEST(SimulationTest, StreamRngIsReproducible) {
+    neuropet::StreamRng a(7, 3);
+    neuropet::StreamRng b(7, 3);
+    neuropet::StreamRng c(7, 4);
+    bool differs = false;
+    for (int i = 0; i < 16; ++i) {
+        auto x = a();
+        EXPECT_EQ(x, b());
+        differs |= x != c();
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(SimulationTest, ParallelRejectsSingleCreature) {
+    neuropet::MatchLedger ledger;
+    EXPECT_THROW(neuropet::run_simulation(1, 0, 1, ledger, 1, 2), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
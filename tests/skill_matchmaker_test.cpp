@@ -0,0 +1,230 @@
+#include "neuropet/skill_matchmaker.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using Clock = neuropet::SkillMatchmaker::Clock;
+
+TEST(SkillMatchmakerTest, EloFollowsLedger) {
+    neuropet::MatchLedger ledger;
+    neuropet::EloRatings elo;
+    ledger.record_result(1, 2);
+    EXPECT_EQ(elo.sync(ledger), 1u);
+    EXPECT_DOUBLE_EQ(elo.rating(1), 1516.0);
+    EXPECT_DOUBLE_EQ(elo.rating(2), 1484.0);
+    EXPECT_DOUBLE_EQ(elo.rating(3), 1500.0);
+    ledger.record_result(2, 1);
+    EXPECT_EQ(elo.sync(ledger), 1u);
+    EXPECT_EQ(elo.sync(ledger), 0u);
+    EXPECT_GT(elo.rating(2), 1500.0 - 1e-9);
+    EXPECT_NEAR(elo.rating(1) + elo.rating(2), 3000.0, 1e-9);
+}
+
+TEST(SkillMatchmakerTest, PairsClosestRatingInsideWindow) {
+    neuropet::MatchLedger ledger;
+    // Give creature 10 a high rating and 20 a low one.
+    for (int i = 0; i < 10; ++i) {
+        ledger.record_result(10, 100 + i);
+        ledger.record_result(200 + i, 20);
+    }
+    neuropet::SkillMatchmaker mm(neuropet::BattleEngine{}, &ledger);
+    auto now = Clock::now();
+    EXPECT_FALSE(mm.enqueue(neuropet::CompactCreature{10, 5, 5, 5}, now));
+    EXPECT_FALSE(mm.enqueue(neuropet::CompactCreature{20, 5, 5, 5}, now));
+    EXPECT_FALSE(mm.enqueue(neuropet::CompactCreature{30, 5, 5, 5}, now));
+    EXPECT_EQ(mm.pending(), 3u);
+    std::size_t before = ledger.results().size();
+    // An unrated newcomer fights the other unrated creature, not 10 or 20.
+    ASSERT_TRUE(mm.enqueue(neuropet::CompactCreature{40, 5, 5, 5}, now));
+    ASSERT_EQ(ledger.results().size(), before + 1);
+    const auto& r = ledger.results().back();
+    EXPECT_EQ(std::min(r.winner, r.loser), 30u);
+    EXPECT_EQ(std::max(r.winner, r.loser), 40u);
+    EXPECT_EQ(mm.pending(), 2u);
+}
+
+TEST(SkillMatchmakerTest, WindowWidensWithWaitTime) {
+    neuropet::MatchLedger ledger;
+    for (int i = 0; i < 10; ++i)
+        ledger.record_result(1, 100 + i);
+    neuropet::SkillMatchmakerOptions opts;
+    opts.base_window = 10.0;
+    opts.widen_per_second = 100.0;
+    neuropet::SkillMatchmaker mm(neuropet::BattleEngine{}, &ledger, opts);
+    auto start = Clock::now();
+    double gap = mm.rating(1) - mm.rating(2);
+    ASSERT_GT(gap, 100.0);
+    EXPECT_FALSE(mm.enqueue(neuropet::CompactCreature{1, 5, 5, 5}, start));
+    EXPECT_FALSE(mm.enqueue(neuropet::CompactCreature{2, 5, 5, 5}, start));
+    EXPECT_EQ(mm.tick(start + std::chrono::milliseconds(100)), 0u);
+    auto later = start + std::chrono::duration_cast<Clock::duration>(
+                             std::chrono::duration<double>(gap / 100.0 + 0.1));
+    EXPECT_EQ(mm.tick(later), 1u);
+    EXPECT_EQ(mm.pending(), 0u);
+}
+
+TEST(SkillMatchmakerTest, ScansPastNeighboursThatCannotPair) {
+    neuropet::MatchLedger ledger;
+    ledger.record_result(9, 100);
+    neuropet::SkillMatchmakerOptions opts;
+    opts.base_window = 10.0;
+    opts.widen_per_second = 100.0;
+    neuropet::SkillMatchmaker mm(neuropet::BattleEngine{}, &ledger, opts);
+    auto start = Clock::now();
+    EXPECT_FALSE(mm.enqueue(neuropet::CompactCreature{9, 5, 5, 5}, start));
+    EXPECT_FALSE(mm.enqueue(neuropet::CompactCreature{1, 5, 5, 5}, start));
+    // Creature 1 loses elsewhere and queues again below its stale entry, which
+    // sits between it and creature 9 but can never be its opponent.
+    ledger.record_result(50, 1);
+    auto later = start + std::chrono::seconds(1);
+    ASSERT_TRUE(mm.enqueue(neuropet::CompactCreature{1, 5, 5, 5}, later));
+    const auto& r = ledger.results().back();
+    EXPECT_EQ(std::min(r.winner, r.loser), 1u);
+    EXPECT_EQ(std::max(r.winner, r.loser), 9u);
+    EXPECT_EQ(mm.pending(), 1u);
+}
+
+TEST(SkillMatchmakerTest, EqualRatingsPairImmediately) {
+    neuropet::SkillMatchmakerOptions opts;
+    opts.base_window = 0.0;
+    opts.widen_per_second = 0.0;
+    neuropet::SkillMatchmaker mm(neuropet::BattleEngine{}, nullptr, opts);
+    auto now = Clock::now();
+    std::size_t matched = 0;
+    for (std::uint32_t id = 1; id <= 20000; ++id)
+        if (mm.enqueue(neuropet::CompactCreature{id, 3, 3, 3}, now))
+            ++matched;
+    // Every unrated pair meets immediately at identical ratings.
+    EXPECT_EQ(matched, 10000u);
+    EXPECT_EQ(mm.pending(), 0u);
+}
+
+namespace {
+/** Linear-scan model of the pairing rule ``SkillMatchmaker`` implements. */
+struct ReferencePool {
+    struct Waiting {
+        double rating;
+        std::uint64_t seq;
+        std::uint32_t id;
+        Clock::time_point joined;
+    };
+    neuropet::SkillMatchmakerOptions opts;
+    std::vector<Waiting> pool;
+    std::uint64_t seq = 0;
+
+    double window(Clock::time_point joined, Clock::time_point now) const {
+        double waited = std::chrono::duration<double>(now - joined).count();
+        return std::min(opts.max_window,
+                        opts.base_window + opts.widen_per_second * std::max(waited, 0.0));
+    }
+
+    void sort() {
+        std::sort(pool.begin(), pool.end(), [](const Waiting& a, const Waiting& b) {
+            return a.rating < b.rating || (a.rating == b.rating && a.seq < b.seq);
+        });
+    }
+
+    /** Opponent id, or 0 if the creature starts waiting. */
+    std::uint32_t enqueue(std::uint32_t id, double r, Clock::time_point now) {
+        sort();
+        auto accepts = [&](const Waiting& w) {
+            return w.id != id &&
+                   std::abs(w.rating - r) <= std::max(window(now, now), window(w.joined, now));
+        };
+        std::ptrdiff_t above = -1;
+        std::ptrdiff_t below = -1;
+        for (std::size_t i = 0; i < pool.size(); ++i)
+            if (pool[i].rating >= r && accepts(pool[i])) {
+                above = static_cast<std::ptrdiff_t>(i);
+                break;
+            }
+        for (std::size_t i = pool.size(); i-- > 0;)
+            if (pool[i].rating < r && accepts(pool[i])) {
+                below = static_cast<std::ptrdiff_t>(i);
+                break;
+            }
+        auto best = above;
+        if (below >= 0 && (best < 0 || r - pool[below].rating < pool[best].rating - r))
+            best = below;
+        if (best < 0) {
+            pool.push_back({r, seq++, id, now});
+            return 0;
+        }
+        std::uint32_t opponent = pool[best].id;
+        pool.erase(pool.begin() + best);
+        return opponent;
+    }
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> tick(Clock::time_point now) {
+        sort();
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+        std::vector<Waiting> kept;
+        std::size_t i = 0;
+        for (; i + 1 < pool.size();) {
+            const auto& a = pool[i];
+            const auto& b = pool[i + 1];
+            if (a.id != b.id &&
+                b.rating - a.rating <= std::max(window(a.joined, now), window(b.joined, now))) {
+                pairs.emplace_back(a.id, b.id);
+                i += 2;
+            } else {
+                kept.push_back(pool[i++]);
+            }
+        }
+        for (; i < pool.size(); ++i)
+            kept.push_back(pool[i]);
+        pool = kept;
+        return pairs;
+    }
+};
+} // namespace
+
+TEST(SkillMatchmakerTest, MatchesLinearScanReference) {
+    std::mt19937 rng(7);
+    neuropet::MatchLedger ledger;
+    std::uniform_int_distribution<std::uint32_t> pick(1, 300);
+    for (int i = 0; i < 4000; ++i) {
+        std::uint32_t a = pick(rng);
+        std::uint32_t b = pick(rng);
+        if (a != b)
+            ledger.record_result(a, b);
+    }
+    neuropet::SkillMatchmakerOptions opts;
+    opts.base_window = 5.0;
+    opts.widen_per_second = 20.0;
+    opts.max_window = 80.0;
+    neuropet::SkillMatchmaker mm(neuropet::BattleEngine{}, &ledger, opts);
+    ReferencePool ref{opts, {}, 0};
+    auto now = Clock::now();
+    std::uniform_int_distribution<int> step_ms(0, 400);
+    for (int step = 0; step < 6000; ++step) {
+        now += std::chrono::milliseconds(step_ms(rng));
+        if (step % 97 == 96) {
+            std::size_t before = ledger.results().size();
+            auto pairs = ref.tick(now);
+            ASSERT_EQ(mm.tick(now), pairs.size());
+            for (std::size_t i = 0; i < pairs.size(); ++i) {
+                const auto& r = ledger.results()[before + i];
+                EXPECT_EQ(std::minmax(r.winner, r.loser),
+                          std::minmax(pairs[i].first, pairs[i].second));
+            }
+            continue;
+        }
+        std::uint32_t id = pick(rng);
+        std::uint32_t expected = ref.enqueue(id, mm.rating(id), now);
+        auto winner = mm.enqueue(neuropet::CompactCreature{id, 5, 5, 5}, now);
+        ASSERT_EQ(winner.has_value(), expected != 0) << "step " << step;
+        if (winner) {
+            const auto& r = ledger.results().back();
+            ASSERT_EQ(std::minmax(r.winner, r.loser), std::minmax(id, expected)) << step;
+        }
+        ASSERT_EQ(mm.pending(), ref.pool.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
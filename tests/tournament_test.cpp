@@ -0,0 +1,148 @@
+#include "neuropet/tournament.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+
+namespace {
+std::vector<neuropet::CompactCreature> entrants(std::size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> stat(1, 10);
+    std::vector<neuropet::CompactCreature> out;
+    for (std::size_t i = 0; i < n; ++i)
+        out.emplace_back(static_cast<std::uint32_t>(100 + i), stat(rng), stat(rng), stat(rng));
+    return out;
+}
+
+neuropet::TournamentOptions options(neuropet::TournamentFormat format, unsigned threads) {
+    neuropet::TournamentOptions opts;
+    opts.format = format;
+    opts.threads = threads;
+    opts.seed = 5;
+    return opts;
+}
+} // namespace
+
+TEST(TournamentTest, SingleEliminationReportsEveryRound) {
+    auto field = entrants(13, 1);
+    neuropet::MatchLedger ledger;
+    neuropet::BattleEngine engine;
+    neuropet::TournamentEngine te(engine, &ledger,
+                                  options(neuropet::TournamentFormat::SingleElimination, 3));
+    auto result = te.run(field);
+
+    // 13 -> 7 -> 4 -> 2 -> 1, with byes in the odd rounds.
+    ASSERT_EQ(result.report_ids.size(), 4u);
+    EXPECT_EQ(result.report_ids[0].size(), 7u);
+    EXPECT_EQ(result.report_ids[1].size(), 4u);
+    EXPECT_EQ(result.report_ids[2].size(), 2u);
+    EXPECT_EQ(result.report_ids[3].size(), 1u);
+    EXPECT_EQ(result.rounds[0].bye, 112u);
+    EXPECT_EQ(result.report_ids[0].back(), 112u);
+    EXPECT_EQ(result.champion(), result.report_ids.back().front());
+    EXPECT_EQ(ledger.results().size(), 12u);
+
+    // Every report is a subset of the previous player list, as the contract
+    // requires, and winners match the reference engine.
+    std::vector<std::uint32_t> players;
+    for (const auto& c : field)
+        players.push_back(c.id);
+    for (std::size_t r = 0; r < result.rounds.size(); ++r) {
+        for (const auto& m : result.rounds[r].matches)
+            EXPECT_EQ(m.winner, engine.fight(field[m.a - 100], field[m.b - 100], 5u));
+        for (auto w : result.report_ids[r])
+            EXPECT_NE(std::find(players.begin(), players.end(), w), players.end());
+        players = result.report_ids[r];
+    }
+    EXPECT_EQ(result.standings.size(), field.size());
+}
+
+TEST(TournamentTest, SwissAvoidsRematchesAndGivesOneByeEach) {
+    auto field = entrants(9, 2);
+    neuropet::TournamentEngine te(neuropet::BattleEngine(), nullptr,
+                                  options(neuropet::TournamentFormat::Swiss, 2));
+    auto result = te.run(field);
+    ASSERT_EQ(result.rounds.size(), 4u);
+    std::set<std::pair<std::uint32_t, std::uint32_t>> seen;
+    std::set<std::uint32_t> byes;
+    std::uint32_t total_wins = 0;
+    for (const auto& r : result.rounds) {
+        EXPECT_EQ(r.matches.size(), 4u);
+        EXPECT_TRUE(byes.insert(r.bye).second);
+        for (const auto& m : r.matches) {
+            auto key = std::minmax(m.a, m.b);
+            EXPECT_TRUE(seen.insert(key).second) << m.a << " vs " << m.b;
+        }
+    }
+    for (auto s : result.scores)
+        total_wins += s;
+    EXPECT_EQ(total_wins, 4u * 5u);
+    EXPECT_TRUE(std::is_sorted(result.scores.rbegin(), result.scores.rend()));
+    ASSERT_EQ(result.report_ids.size(), 1u);
+    EXPECT_EQ(result.report_ids[0], std::vector<std::uint32_t>{result.champion()});
+}
+
+TEST(TournamentTest, RoundRobinPlaysEveryPairOnce) {
+    for (std::size_t n : {6u, 7u}) {
+        auto field = entrants(n, 3);
+        neuropet::TournamentEngine te(neuropet::BattleEngine(), nullptr,
+                                      options(neuropet::TournamentFormat::RoundRobin, 2));
+        auto result = te.run(field);
+        std::set<std::pair<std::uint32_t, std::uint32_t>> seen;
+        for (const auto& r : result.rounds)
+            for (const auto& m : r.matches)
+                EXPECT_TRUE(seen.insert(std::minmax(m.a, m.b)).second);
+        EXPECT_EQ(seen.size(), n * (n - 1) / 2);
+        std::uint32_t total = 0;
+        for (auto s : result.scores)
+            total += s;
+        EXPECT_EQ(total, n * (n - 1) / 2);
+    }
+}
+
+TEST(TournamentTest, ResultsIndependentOfThreadCount) {
+    auto field = entrants(3000, 4);
+    for (auto format : {neuropet::TournamentFormat::SingleElimination,
+                        neuropet::TournamentFormat::Swiss}) {
+        neuropet::MatchLedger l1;
+        neuropet::MatchLedger l4;
+        auto r1 = neuropet::TournamentEngine(neuropet::BattleEngine(), &l1, options(format, 1))
+                      .run(field);
+        auto r4 = neuropet::TournamentEngine(neuropet::BattleEngine(), &l4, options(format, 4))
+                      .run(field);
+        EXPECT_EQ(r1.standings, r4.standings);
+        EXPECT_EQ(r1.report_ids, r4.report_ids);
+        ASSERT_EQ(l1.results().size(), l4.results().size());
+        for (std::size_t i = 0; i < l1.results().size(); ++i)
+            EXPECT_EQ(l1.results()[i].winner, l4.results()[i].winner);
+    }
+}
+
+TEST(TournamentTest, ReportsTranslateIdsToAddresses) {
+    auto field = entrants(5, 6);
+    auto result = neuropet::TournamentEngine(neuropet::BattleEngine(), nullptr,
+                                             options(neuropet::TournamentFormat::SingleElimination, 1))
+                      .run(field);
+    auto reports =
+        result.reports([](std::uint32_t id) { return "0xplayer" + std::to_string(id); });
+    ASSERT_EQ(reports.size(), result.report_ids.size());
+    for (std::size_t r = 0; r < reports.size(); ++r) {
+        ASSERT_EQ(reports[r].size(), result.report_ids[r].size());
+        for (std::size_t i = 0; i < reports[r].size(); ++i)
+            EXPECT_EQ(reports[r][i], "0xplayer" + std::to_string(result.report_ids[r][i]));
+    }
+    EXPECT_EQ(reports.back(),
+              std::vector<std::string>{"0xplayer" + std::to_string(result.champion())});
+}
+
+TEST(TournamentTest, RejectsTinyFields) {
+    neuropet::TournamentEngine te;
+    EXPECT_THROW(te.run(entrants(1, 5)), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
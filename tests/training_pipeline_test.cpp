@@ -0,0 +1,198 @@
+#include "neuropet/training.hpp"
+#include <atomic>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+struct SequenceProducer : harmonics::Producer {
+    explicit SequenceProducer(std::size_t n) : n_{n} {}
+    harmonics::HTensor next() override {
+        harmonics::HTensor t{harmonics::HTensor::DType::Float32, {1}};
+        t.data().resize(sizeof(float));
+        *reinterpret_cast<float*>(t.data().data()) = static_cast<float>(index_++ % n_);
+        return t;
+    }
+    std::size_t size() const override { return n_; }
+    std::size_t n_;
+    std::size_t index_{0};
+};
+
+TEST(TrainingPipelineTest, PrefetchPreservesOrder) {
+    auto base = std::make_shared<SequenceProducer>(4);
+    neuropet::PrefetchProducer prefetch(base, 2);
+    EXPECT_EQ(prefetch.size(), 4u);
+    for (int i = 0; i < 10; ++i) {
+        auto t = prefetch.next();
+        EXPECT_EQ(*reinterpret_cast<const float*>(t.data().data()), static_cast<float>(i % 4));
+    }
+}
+
+struct FailingProducer : SequenceProducer {
+    FailingProducer() : SequenceProducer(8) {}
+    harmonics::HTensor next() override {
+        if (index_ == 3)
+            throw std::runtime_error("source failed");
+        return SequenceProducer::next();
+    }
+};
+
+TEST(TrainingPipelineTest, PrefetchRethrowsSourceErrors) {
+    neuropet::PrefetchProducer prefetch(std::make_shared<FailingProducer>(), 4);
+    for (int i = 0; i < 3; ++i) {
+        auto t = prefetch.next();
+        EXPECT_EQ(*reinterpret_cast<const float*>(t.data().data()), static_cast<float>(i));
+    }
+    EXPECT_THROW(prefetch.next(), std::runtime_error);
+    EXPECT_THROW(prefetch.next(), std::runtime_error);
+}
+
+TEST(TrainingPipelineTest, AutoPolicyTrainsThroughFitUntil) {
+    neuropet::TrainingPipelineConfig cfg;
+    cfg.input = std::make_shared<SequenceProducer>(3);
+    cfg.steps = 4;
+    cfg.auto_policy = true;
+    std::vector<std::uint32_t> steps;
+    cfg.metrics = [&](const neuropet::TrainingMetrics& m) { steps.push_back(m.step); };
+    neuropet::TrainingPipeline pipeline(cfg);
+    EXPECT_EQ(pipeline.run(), 4u);
+    EXPECT_EQ(steps, (std::vector<std::uint32_t>{1, 2, 3, 4}));
+    EXPECT_EQ(pipeline.timings().steps, 4u);
+    EXPECT_EQ(pipeline.timings().update, 0.0);
+
+    cfg.checkpoint.path = "auto_policy.ckpt";
+    EXPECT_THROW(neuropet::TrainingPipeline(cfg).run(), std::runtime_error);
+}
+
+TEST(TrainingPipelineTest, RunsConfiguredStepsAndTimesStages) {
+    neuropet::TrainingPipelineConfig cfg;
+    cfg.input = std::make_shared<SequenceProducer>(3);
+    cfg.prefetch_depth = 2;
+    cfg.steps = 5;
+    std::vector<std::uint32_t> steps;
+    cfg.metrics = [&](const neuropet::TrainingMetrics& m) { steps.push_back(m.step); };
+    neuropet::TrainingPipeline pipeline(std::move(cfg));
+    EXPECT_EQ(pipeline.run(), 5u);
+    ASSERT_EQ(steps.size(), 5u);
+    for (std::size_t i = 0; i < steps.size(); ++i)
+        EXPECT_EQ(steps[i], i + 1);
+    const auto& t = pipeline.timings();
+    EXPECT_EQ(t.steps, 5u);
+    EXPECT_GE(t.io, 0.0);
+    EXPECT_GE(t.forward, 0.0);
+    EXPECT_GE(t.total(), t.update);
+}
+
+static harmonics::HTensor float_tensor(std::vector<float> v) {
+    harmonics::HTensor t{harmonics::HTensor::DType::Float32, {v.size()}};
+    t.data().resize(v.size() * sizeof(float));
+    std::memcpy(t.data().data(), v.data(), t.data().size());
+    return t;
+}
+
+TEST(TrainingPipelineTest, GradientReductionIsIndependentOfThreadCount) {
+    auto make = []() {
+        std::vector<std::vector<harmonics::HTensor>> g(5);
+        for (std::size_t r = 0; r < g.size(); ++r)
+            for (std::size_t j = 0; j < 3; ++j)
+                g[r].push_back(float_tensor({0.1f * (r + 1), 1e7f / (r + 1) + j, -0.3f * j}));
+        return g;
+    };
+    auto run = [&](unsigned threads) {
+        auto g = make();
+        std::vector<std::vector<harmonics::HTensor>*> ptrs;
+        for (auto& r : g)
+            ptrs.push_back(&r);
+        neuropet::reduce_gradients(ptrs, threads);
+        return g[0];
+    };
+    auto one = run(1);
+    auto many = run(4);
+    auto ref = make();
+    for (std::size_t j = 0; j < 3; ++j) {
+        ASSERT_EQ(one[j].data(), many[j].data());
+        const float* a = reinterpret_cast<const float*>(one[j].data().data());
+        for (std::size_t e = 0; e < 3; ++e) {
+            auto at = [&](std::size_t r) {
+                return reinterpret_cast<const float*>(ref[r][j].data().data())[e];
+            };
+            float expected = (((at(0) + at(1)) + (at(2) + at(3))) + at(4)) / 5.0f;
+            EXPECT_EQ(a[e], expected);
+        }
+    }
+}
+
+TEST(TrainingPipelineTest, WorkerPoolIsReusedAcrossCalls) {
+    neuropet::WorkerPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+    std::vector<int> hits(37, 0);
+    for (int round = 0; round < 500; ++round)
+        pool.parallel_for(hits.size(), [&](std::size_t i) { ++hits[i]; });
+    for (int h : hits)
+        EXPECT_EQ(h, 500);
+    EXPECT_THROW(pool.parallel_for(hits.size(),
+                                   [](std::size_t i) {
+                                       if (i == 5)
+                                           throw std::runtime_error("boom");
+                                   }),
+                 std::runtime_error);
+    std::atomic<std::size_t> sum{0};
+    pool.parallel_for(100, [&](std::size_t i) { sum += i; });
+    EXPECT_EQ(sum.load(), 4950u);
+}
+
+TEST(TrainingPipelineTest, DataParallelReplicasRunEveryStep) {
+    neuropet::TrainingPipelineConfig cfg;
+    cfg.input = std::make_shared<SequenceProducer>(8);
+    cfg.steps = 3;
+    cfg.replicas = 4;
+    cfg.threads = 2;
+    std::vector<std::uint32_t> steps;
+    cfg.metrics = [&](const neuropet::TrainingMetrics& m) { steps.push_back(m.step); };
+    neuropet::TrainingPipeline pipeline(std::move(cfg));
+    EXPECT_EQ(pipeline.run(), 3u);
+    EXPECT_EQ(steps, (std::vector<std::uint32_t>{1, 2, 3}));
+}
+
+TEST(TrainingPipelineTest, ReplicaTrainingIsIndependentOfThreadCount) {
+    auto train = [](unsigned threads) {
+        neuropet::TrainingPipelineConfig cfg;
+        cfg.input = std::make_shared<SequenceProducer>(7);
+        cfg.fit.optimizer = harmonics::Optimizer::Adam;
+        cfg.steps = 6;
+        cfg.replicas = 4;
+        cfg.threads = threads;
+        std::vector<float> losses;
+        cfg.metrics = [&](const neuropet::TrainingMetrics& m) { losses.push_back(m.loss); };
+        neuropet::TrainingPipeline pipeline(std::move(cfg));
+        pipeline.run();
+        return std::make_pair(pipeline.parameters(), losses);
+    };
+    auto one = train(1);
+    ASSERT_EQ(one.second.size(), 6u);
+    for (unsigned threads : {2u, 4u}) {
+        auto many = train(threads);
+        ASSERT_EQ(many.first.size(), one.first.size());
+        for (std::size_t j = 0; j < one.first.size(); ++j)
+            EXPECT_EQ(many.first[j].data(), one.first[j].data());
+        EXPECT_EQ(many.second, one.second);
+    }
+}
+
+TEST(TrainingPipelineTest, ConcurrentPipelinesTrainIndependently) {
+    std::vector<std::vector<std::uint32_t>> steps(8);
+    neuropet::parallel_for(steps.size(), 4, [&](std::size_t i) {
+        neuropet::TrainingPipelineConfig cfg;
+        cfg.input = std::make_shared<SequenceProducer>(5);
+        cfg.steps = 3 + i % 3;
+        cfg.auto_policy = i % 2 == 0;
+        cfg.metrics = [&, i](const neuropet::TrainingMetrics& m) { steps[i].push_back(m.step); };
+        neuropet::TrainingPipeline(std::move(cfg)).run();
+    });
+    for (std::size_t i = 0; i < steps.size(); ++i)
+        EXPECT_EQ(steps[i].size(), 3 + i % 3);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,7 +1,35 @@
 #include "neuropet/proof_system.hpp"
+#include "neuropet/trait_columns.hpp"
 #include "neuropet/traits.hpp"
 #include <gtest/gtest.h>
 
+#include <random>
+
+namespace {
+neuropet::VisualTraits random_traits(std::mt19937& rng) {
+    std::uniform_int_distribution<int> nib(0, 15);
+    std::uniform_int_distribution<int> count(0, 4);
+    auto hsv = [&] {
+        return neuropet::HSV{static_cast<uint8_t>(nib(rng)), static_cast<uint8_t>(nib(rng)),
+                             static_cast<uint8_t>(nib(rng))};
+    };
+    neuropet::VisualTraits t{};
+    t.sensor_count = static_cast<uint8_t>(count(rng));
+    t.appendage_count = static_cast<uint8_t>(std::min(count(rng), 7 - t.sensor_count));
+    t.body_shape = static_cast<uint8_t>(nib(rng));
+    t.body_colour = hsv();
+    for (unsigned i = 0; i < t.sensor_count; ++i) {
+        t.sensor_shape[i] = static_cast<uint8_t>(nib(rng));
+        t.sensor_colour[i] = hsv();
+    }
+    for (unsigned i = 0; i < t.appendage_count; ++i) {
+        t.appendage_shape[i] = static_cast<uint8_t>(nib(rng));
+        t.appendage_colour[i] = hsv();
+    }
+    return t;
+}
+} // namespace
+
 TEST(TraitPack, RoundTrip) {
     neuropet::VisualTraits t{};
     t.body_shape = 3;
@@ -41,6 +69,62 @@ TEST(TraitPack, NameHash) {
     EXPECT_EQ(hex, "19df2a7272ef22a6e7f5f05eefd555ab5ed934a44a5d53cd31e75709ac7cb011");
 }
 
+TEST(TraitPack, BulkCodecMatchesScalar) {
+    std::mt19937 rng(11);
+    std::vector<neuropet::VisualTraits> traits;
+    neuropet::TraitColumns cols;
+    for (int i = 0; i < 2000; ++i) {
+        traits.push_back(random_traits(rng));
+        cols.push_back(traits.back());
+    }
+    auto packed = neuropet::pack_traits_bulk(cols);
+    ASSERT_EQ(packed.size(), traits.size());
+    for (std::size_t i = 0; i < traits.size(); ++i)
+        ASSERT_TRUE(packed[i] == neuropet::pack_traits(traits[i])) << "row " << i;
+
+    auto back = neuropet::unpack_traits_bulk(packed.data(), cols.sensor_count.data(),
+                                             cols.appendage_count.data(), packed.size());
+    for (std::size_t i = 0; i < traits.size(); ++i) {
+        auto want = neuropet::unpack_traits(packed[i], traits[i].sensor_count,
+                                            traits[i].appendage_count);
+        auto got = back.at(i);
+        ASSERT_TRUE(neuropet::pack_traits(got) == neuropet::pack_traits(want)) << "row " << i;
+        EXPECT_EQ(got.body_shape, want.body_shape);
+        EXPECT_EQ(got.sensor_shape, want.sensor_shape);
+        EXPECT_EQ(got.appendage_shape, want.appendage_shape);
+    }
+}
+
+TEST(TraitPack, BitmapIndexMatchesScan) {
+    std::mt19937 rng(5);
+    neuropet::TraitColumns cols;
+    for (int i = 0; i < 3000; ++i)
+        cols.push_back(random_traits(rng));
+    neuropet::TraitIndex index(cols);
+    using neuropet::TraitField;
+
+    auto hits = index.select({{TraitField::BodyShape, 3}, {TraitField::SensorHue, 7}});
+    std::vector<std::size_t> want;
+    for (std::size_t i = 0; i < cols.size(); ++i) {
+        bool sensor = false;
+        for (unsigned k = 0; k < cols.sensor_count[i]; ++k)
+            sensor = sensor || cols.sensor[k].hue[i] == 7;
+        if (cols.body.shape[i] == 3 && sensor)
+            want.push_back(i);
+    }
+    EXPECT_EQ(hits.rows(), want);
+    EXPECT_EQ(hits.count(), want.size());
+
+    auto any = index.bitmap(TraitField::AppendageCount, 0);
+    any |= index.bitmap(TraitField::AppendageCount, 1);
+    std::size_t few = 0;
+    for (std::size_t i = 0; i < cols.size(); ++i)
+        few += cols.appendage_count[i] <= 1;
+    EXPECT_EQ(any.count(), few);
+    EXPECT_EQ(index.select({}).count(), cols.size());
+    EXPECT_THROW(index.bitmap(TraitField::BodyHue, 16), std::runtime_error);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,145 @@
+#include "neuropet/weight_delta.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+
+static neuropet::WeightTensors make_epoch(std::uint32_t epoch) {
+    neuropet::WeightTensors t{std::vector<int8_t>(256), std::vector<int8_t>(16)};
+    for (std::size_t i = 0; i < t[0].size(); ++i)
+        t[0][i] = static_cast<int8_t>(i * 7 % 17 - 8);
+    for (std::size_t i = 0; i < t[1].size(); ++i)
+        t[1][i] = static_cast<int8_t>(i);
+    // A handful of weights change each epoch.
+    for (std::uint32_t e = 1; e <= epoch; ++e)
+        t[0][(e * 37) % t[0].size()] += 1;
+    return t;
+}
+
+TEST(WeightDeltaTest, DeltaFrameRoundTrip) {
+    auto base = make_epoch(0);
+    auto upd = make_epoch(1);
+    auto frame = neuropet::encode_weight_frame(&base, upd, 1);
+    neuropet::WeightFrameInfo info;
+    auto out = neuropet::apply_weight_frame(&base, frame, &info);
+    EXPECT_EQ(out, upd);
+    EXPECT_EQ(info.kind, neuropet::WeightFrameKind::Delta);
+    EXPECT_EQ(info.epoch, 1u);
+}
+
+TEST(WeightDeltaTest, LayoutChangeForcesKeyframe) {
+    auto base = make_epoch(0);
+    neuropet::WeightTensors upd{{1, 2, 3}};
+    auto frame = neuropet::encode_weight_frame(&base, upd, 1);
+    neuropet::WeightFrameInfo info;
+    EXPECT_EQ(neuropet::apply_weight_frame(nullptr, frame, &info), upd);
+    EXPECT_EQ(info.kind, neuropet::WeightFrameKind::Keyframe);
+}
+
+TEST(WeightDeltaTest, ChainReconstructsEveryEpoch) {
+    neuropet::WeightDeltaChain chain(4);
+    for (std::uint32_t e = 0; e < 10; ++e)
+        EXPECT_EQ(chain.append(make_epoch(e)), e);
+    for (std::uint32_t e = 0; e < 10; ++e)
+        EXPECT_EQ(chain.reconstruct(e), make_epoch(e));
+
+    std::stringstream ss;
+    chain.save(ss);
+    auto loaded = neuropet::WeightDeltaChain::load(ss);
+    ASSERT_EQ(loaded.size(), chain.size());
+    EXPECT_EQ(loaded.reconstruct(7), make_epoch(7));
+    EXPECT_EQ(loaded.append(make_epoch(10)), 10u);
+    EXPECT_EQ(loaded.reconstruct(10), make_epoch(10));
+}
+
+TEST(WeightDeltaTest, NetworkTensorsRoundTrip) {
+    neuropet::Int8Network net;
+    net.layers.push_back({neuropet::Int8Op::Dense, 2, 1, {1, 2}, {3}});
+    auto t = neuropet::network_tensors(net);
+    ASSERT_EQ(t.size(), 2u);
+    t[0][1] = 5;
+    neuropet::assign_network_tensors(net, t);
+    EXPECT_EQ(net.layers[0].weights[1], 5);
+}
+
+TEST(WeightDeltaTest, LargeFrameRoundTrip) {
+    neuropet::WeightTensors base{std::vector<int8_t>(3 << 20, 1), {}};
+    auto upd = base;
+    upd[0][(3 << 20) - 1] = 2;
+    EXPECT_EQ(neuropet::apply_weight_frame(nullptr, neuropet::encode_weight_frame(nullptr, upd, 0)),
+              upd);
+    EXPECT_EQ(neuropet::apply_weight_frame(&base, neuropet::encode_weight_frame(&base, upd, 1)),
+              upd);
+}
+
+static void put_le(std::vector<std::uint8_t>& f, std::size_t at, std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i)
+        f[at + i] = static_cast<std::uint8_t>(v >> (8 * i));
+}
+
+TEST(WeightDeltaTest, RejectsForgedFrameHeaders) {
+    // Header claiming 2^31 - 1 tensors in an 18 byte frame.
+    std::vector<std::uint8_t> huge{'N', 'P', 'W', 'D', 1, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    huge.insert(huge.end(), {0xff, 0xff, 0xff, 0x7f});
+    EXPECT_THROW(neuropet::apply_weight_frame(nullptr, huge), std::runtime_error);
+
+    auto t = make_epoch(0);
+    auto frame = neuropet::encode_weight_frame(nullptr, t, 0);
+    auto bad_codec = frame;
+    bad_codec[9] = 7;
+    EXPECT_THROW(neuropet::apply_weight_frame(nullptr, bad_codec), std::runtime_error);
+    auto bad_kind = frame;
+    bad_kind[8] = 9;
+    EXPECT_THROW(neuropet::apply_weight_frame(nullptr, bad_kind), std::runtime_error);
+
+    // Tensor sizes and raw size inflated consistently to about 8 GB.
+    const std::size_t sizes = 18;
+    const std::size_t raw = sizes + 4 * t.size();
+    auto inflated = frame;
+    put_le(inflated, sizes, 0xffffffffu, 4);
+    put_le(inflated, sizes + 4, 0xffffffffu, 4);
+    put_le(inflated, raw, 0x1fffffffeull, 8);
+    EXPECT_THROW(neuropet::apply_weight_frame(nullptr, inflated), std::runtime_error);
+    auto mismatched = frame;
+    put_le(mismatched, raw, 1u << 30, 8);
+    EXPECT_THROW(neuropet::apply_weight_frame(nullptr, mismatched), std::runtime_error);
+}
+
+TEST(WeightDeltaTest, ChainLoadRejectsForgedFrameLength) {
+    std::stringstream ss;
+    ss.write("NPWC", 4);
+    neuropet::write_u32(ss, 4);
+    neuropet::write_u32(ss, 1);
+    neuropet::write_u32(ss, 0xfffffff0u);
+    ss.write("NPWD", 4);
+    EXPECT_THROW(neuropet::WeightDeltaChain::load(ss), std::runtime_error);
+}
+
+TEST(WeightDeltaTest, ChainLoadRejectsForgedFrameOrder) {
+    auto save_frames = [](const std::vector<std::vector<std::uint8_t>>& frames) {
+        auto ss = std::make_unique<std::stringstream>();
+        ss->write("NPWC", 4);
+        neuropet::write_u32(*ss, 4);
+        neuropet::write_u32(*ss, static_cast<std::uint32_t>(frames.size()));
+        for (const auto& f : frames) {
+            neuropet::write_u32(*ss, static_cast<std::uint32_t>(f.size()));
+            ss->write(reinterpret_cast<const char*>(f.data()),
+                      static_cast<std::streamsize>(f.size()));
+        }
+        return ss;
+    };
+    // A delta over zero tensors as the first frame has no keyframe to start from.
+    neuropet::WeightTensors none;
+    auto ss = save_frames({neuropet::encode_weight_frame(&none, none, 0)});
+    EXPECT_THROW(neuropet::WeightDeltaChain::load(*ss), std::runtime_error);
+
+    auto e0 = make_epoch(0);
+    auto e1 = make_epoch(1);
+    ss = save_frames({neuropet::encode_weight_frame(nullptr, e0, 0),
+                      neuropet::encode_weight_frame(&e0, e1, 5)});
+    EXPECT_THROW(neuropet::WeightDeltaChain::load(*ss), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+#include "neuropet/win_matrix.hpp"
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace {
+neuropet::WinMatrixConfig small_config(unsigned threads) {
+    neuropet::WinMatrixConfig cfg;
+    cfg.stat_min = 1;
+    cfg.stat_max = 4;
+    cfg.loadouts = {{}, {neuropet::Item{1, 2, 0, 1}}};
+    cfg.seeds = {0, 1, 2, 3, 7};
+    neuropet::BattleEngine hazards;
+    hazards.set_tile(3, 0, neuropet::BattleEngine::Tile::HAZARD);
+    hazards.set_tile(7, 5, neuropet::BattleEngine::Tile::HAZARD);
+    hazards.set_tile(5, 0, neuropet::BattleEngine::Tile::WALL);
+    cfg.boards = {neuropet::BattleEngine{}, hazards};
+    cfg.threads = threads;
+    return cfg;
+}
+} // namespace
+
+TEST(WinMatrixTest, MatchesReferenceFights) {
+    auto cfg = small_config(3);
+    auto m = neuropet::compute_win_matrix(cfg);
+    const std::size_t n = m.size();
+    ASSERT_EQ(n, 4u * 4u * 4u * 2u);
+    EXPECT_EQ(m.battles_per_cell, 10u);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const auto& pa = m.profiles[i];
+            const auto& pb = m.profiles[j];
+            neuropet::CreatureStats a{static_cast<std::uint32_t>(i + 1), pa.power, pa.defense,
+                                      pa.stamina, cfg.loadouts[pa.loadout]};
+            neuropet::CreatureStats b{static_cast<std::uint32_t>(j + 1 + n), pb.power,
+                                      pb.defense, pb.stamina, cfg.loadouts[pb.loadout]};
+            unsigned wins = 0;
+            for (const auto& board : cfg.boards)
+                for (auto seed : cfg.seeds)
+                    wins += board.fight(a, b, seed) == a.id;
+            ASSERT_EQ(m.win_count(i, j), wins) << i << " vs " << j;
+        }
+    }
+}
+
+TEST(WinMatrixTest, IndependentOfThreadCount) {
+    auto serial = neuropet::compute_win_matrix(small_config(1));
+    auto parallel = neuropet::compute_win_matrix(small_config(4));
+    EXPECT_EQ(serial.wins, parallel.wins);
+}
+
+TEST(WinMatrixTest, SaveLoadAndSummary) {
+    auto m = neuropet::compute_win_matrix(small_config(2));
+    std::stringstream ss;
+    m.save(ss);
+    auto loaded = neuropet::WinMatrix::load(ss);
+    EXPECT_EQ(loaded.wins, m.wins);
+    ASSERT_EQ(loaded.size(), m.size());
+    EXPECT_EQ(loaded.profiles.back().loadout, 1u);
+    EXPECT_EQ(loaded.battles_per_cell, m.battles_per_cell);
+
+    auto s = m.summary();
+    EXPECT_GT(s.mean, 0.0);
+    EXPECT_LE(s.min, s.mean);
+    EXPECT_GE(s.max, s.mean);
+    EXPECT_DOUBLE_EQ(m.profile_win_rate(s.best), s.max);
+    // The strongest base stats with the item loadout can't be the weakest.
+    EXPECT_GT(m.profile_win_rate(m.size() - 1), m.profile_win_rate(0));
+}
+
+TEST(WinMatrixTest, RejectsOversizedCells) {
+    neuropet::WinMatrixConfig cfg;
+    cfg.stat_max = 1;
+    cfg.seeds.assign(70000, 1);
+    EXPECT_THROW(neuropet::compute_win_matrix(cfg), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -5,6 +5,10 @@
 #include <harmonics/graph_diff.hpp>
 #include <harmonics/serialization.hpp>
 #include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "neuropet/weight_delta.hpp"
 
 using namespace harmonics;
 
@@ -82,7 +86,17 @@ static GraphDiff load_graph_diff(std::istream& in) {
 
 static void usage(const char* arg0) {
     std::cout << "Usage: " << arg0
-              << " <diff|apply|merge> <files> [-o out]" << std::endl;
+              << " <diff|apply|merge|wdiff|wapply> <files> [-o out]" << std::endl;
+}
+
+static std::string output_arg(int argc, char** argv, const std::string& fallback) {
+    std::string out_path = fallback;
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+            out_path = argv[++i];
+    }
+    return out_path;
 }
 
 static void print_summary(const GraphDiff& diff) {
@@ -190,6 +204,61 @@ int main(int argc, char** argv) {
         }
         save_graph(merged, out);
         return 0;
+    } else if (cmd == "wdiff") {
+        if (argc < 4) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string out_path = output_arg(argc, argv, "");
+        neuropet::WeightTensors base;
+        neuropet::WeightTensors upd;
+        try {
+            base = neuropet::network_tensors(neuropet::load_network(argv[2]));
+            upd = neuropet::network_tensors(neuropet::load_network(argv[3]));
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        auto frame = neuropet::encode_weight_frame(&base, upd, 0);
+        if (out_path.empty()) {
+            std::size_t raw = 0;
+            for (const auto& t : upd)
+                raw += t.size();
+            std::cout << raw << " weight bytes, " << frame.size() << " bytes encoded"
+                      << std::endl;
+            return 0;
+        }
+        std::ofstream out(out_path, std::ios::binary);
+        if (!out) {
+            std::cerr << "failed to open output file" << std::endl;
+            return 1;
+        }
+        out.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+        return 0;
+    } else if (cmd == "wapply") {
+        if (argc < 4) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string net_path = argv[2];
+        std::string out_path = output_arg(argc, argv, net_path);
+        std::ifstream din(argv[3], std::ios::binary);
+        if (!din) {
+            std::cerr << "failed to open input files" << std::endl;
+            return 1;
+        }
+        std::vector<std::uint8_t> frame((std::istreambuf_iterator<char>(din)),
+                                        std::istreambuf_iterator<char>());
+        try {
+            auto net = neuropet::load_network(net_path);
+            auto base = neuropet::network_tensors(net);
+            neuropet::assign_network_tensors(net, neuropet::apply_weight_frame(&base, frame));
+            neuropet::save_network(net, out_path);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
     } else {
         usage(argv[0]);
         return 1;
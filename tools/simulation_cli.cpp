@@ -1,23 +1,36 @@
 #include "neuropet/simulation.hpp"
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
 
 int main(int argc, char** argv) {
     std::size_t creatures = 5;
     std::size_t steps = 5;
     std::size_t battles = 3;
     unsigned seed = 0;
-    if (argc > 1)
-        creatures = static_cast<std::size_t>(std::stoul(argv[1]));
-    if (argc > 2)
-        steps = static_cast<std::size_t>(std::stoul(argv[2]));
-    if (argc > 3)
-        battles = static_cast<std::size_t>(std::stoul(argv[3]));
-    if (argc > 4)
-        seed = static_cast<unsigned>(std::stoul(argv[4]));
+    unsigned threads = 0;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (std::strncmp(argv[i], "--threads=", 10) == 0)
+            threads = static_cast<unsigned>(std::stoul(argv[i] + 10));
+        else
+            args.emplace_back(argv[i]);
+    }
+    if (args.size() > 0)
+        creatures = static_cast<std::size_t>(std::stoul(args[0]));
+    if (args.size() > 1)
+        steps = static_cast<std::size_t>(std::stoul(args[1]));
+    if (args.size() > 2)
+        battles = static_cast<std::size_t>(std::stoul(args[2]));
+    if (args.size() > 3)
+        seed = static_cast<unsigned>(std::stoul(args[3]));
 
-    std::mt19937 rng(seed ? seed : std::random_device{}());
     neuropet::MatchLedger ledger;
-    neuropet::run_simulation(creatures, steps, battles, ledger, rng);
+    neuropet::run_simulation(creatures, steps, battles, ledger,
+                             seed ? seed : std::random_device{}(), threads);
 
     for (const auto& r : ledger.results())
         std::cout << "Battle " << r.battle_id << ": winner=" << r.winner
@@ -0,0 +1,94 @@
+#include "neuropet/win_matrix.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static bool parse_triple(const char* s, int& a, int& b, int& c) {
+    return std::sscanf(s, "%d,%d,%d", &a, &b, &c) == 3;
+}
+
+static bool parse_pair(const char* s, int& a, int& b) {
+    return std::sscanf(s, "%d,%d", &a, &b) == 2;
+}
+
+static void usage() {
+    std::cerr << "Usage: win_matrix_cli <output> [seeds] [--threads N] [--loadout p,d,s]...\n"
+              << "                      [--hazard x,y]... [--wall x,y]...\n";
+}
+
+int main(int argc, char** argv) {
+    neuropet::WinMatrixConfig cfg;
+    neuropet::BattleEngine board;
+    bool custom_board = false;
+    std::string output;
+    std::size_t seeds = 2;
+    std::uint32_t next_item = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        int x = 0, y = 0, z = 0;
+        if (arg == "--threads" && has_value) {
+            cfg.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--loadout" && has_value && parse_triple(argv[i + 1], x, y, z)) {
+            cfg.loadouts.push_back({neuropet::Item{next_item++, x, y, z}});
+            ++i;
+        } else if ((arg == "--hazard" || arg == "--wall") && has_value &&
+                   parse_pair(argv[i + 1], x, y)) {
+            board.set_tile(x, y,
+                           arg == "--wall" ? neuropet::BattleEngine::Tile::WALL
+                                           : neuropet::BattleEngine::Tile::HAZARD);
+            custom_board = true;
+            ++i;
+        } else if (output.empty() && arg.rfind("--", 0) != 0) {
+            output = arg;
+        } else if (arg.rfind("--", 0) != 0) {
+            seeds = static_cast<std::size_t>(std::stoul(arg));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (output.empty()) {
+        usage();
+        return 1;
+    }
+    cfg.seeds.clear();
+    for (std::size_t s = 1; s <= seeds; ++s)
+        cfg.seeds.push_back(static_cast<std::uint32_t>(s));
+    if (custom_board)
+        cfg.boards.push_back(board);
+
+    auto start = std::chrono::steady_clock::now();
+    neuropet::WinMatrix m;
+    try {
+        m = neuropet::compute_win_matrix(cfg);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream out(output, std::ios::binary);
+    m.save(out);
+    if (!out) {
+        std::cerr << "failed to write " << output << std::endl;
+        return 1;
+    }
+
+    auto s = m.summary();
+    auto describe = [&](std::size_t i) {
+        const auto& p = m.profiles[i];
+        return std::to_string(p.power) + "/" + std::to_string(p.defense) + "/" +
+               std::to_string(p.stamina) + " loadout " + std::to_string(p.loadout);
+    };
+    double battles = static_cast<double>(m.size()) * m.size() * m.battles_per_cell;
+    std::cout << "profiles: " << m.size() << "\n"
+              << "battles: " << battles << " in " << secs << " s\n"
+              << "mean win rate: " << s.mean << " (stddev " << s.stddev << ")\n"
+              << "best: " << describe(s.best) << " at " << s.max << "\n"
+              << "worst: " << describe(s.worst) << " at " << s.min << std::endl;
+    return 0;
+}